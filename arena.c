@@ -0,0 +1,227 @@
+#include "arena.h"
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+
+/* -------------------------------------------------------------------------- */
+/* Arena Structure                                                            */
+/* -------------------------------------------------------------------------- */
+
+/* Size classes step by powers of two with a midpoint between each, 32 B to
+ * 1 MB: 32, 48, 64, 96, 128, ... Every class is a multiple of 16, so blocks
+ * carved back to back stay 16-byte aligned. Larger blocks are mapped directly. */
+#define ARENA_MIN_SIZE 32u
+#define ARENA_MAX_SIZE (1u << 20)
+#define ARENA_CLASS_COUNT 31
+
+/* Regions are mapped from the system and never returned; classes take slabs
+ * of about ARENA_SLAB_SIZE from the current region when their list runs dry */
+#define ARENA_REGION_SIZE (2u << 20)
+#define ARENA_SLAB_SIZE (64u << 10)
+
+typedef struct ArenaBlock {
+    struct ArenaBlock *next;
+} ArenaBlock;
+
+typedef struct {
+    pthread_mutex_t lock;
+    ArenaBlock *free_list;
+} ArenaClass;
+
+static struct {
+    pthread_once_t once;
+    ArenaClass classes[ARENA_CLASS_COUNT];
+
+    pthread_mutex_t region_lock;
+    uint8_t *region;
+    size_t region_used;
+
+    atomic_size_t in_use;
+    atomic_size_t peak_in_use;
+    atomic_size_t reserved;
+    atomic_size_t system_allocs;
+} arena = {.once = PTHREAD_ONCE_INIT};
+
+/* -------------------------------------------------------------------------- */
+/* Error Handling                                                             */
+/* -------------------------------------------------------------------------- */
+
+static void arena_die(const char *message) {
+    fprintf(stderr, "Error: %s\n", message);
+    exit(EXIT_FAILURE);
+}
+
+/* -------------------------------------------------------------------------- */
+/* Helpers                                                                    */
+/* -------------------------------------------------------------------------- */
+
+static void arena_init_once(void) {
+    for (int i = 0; i < ARENA_CLASS_COUNT; ++i) {
+        if (pthread_mutex_init(&arena.classes[i].lock, NULL) != 0) {
+            arena_die("Failed to initialize chunk arena");
+        }
+    }
+    if (pthread_mutex_init(&arena.region_lock, NULL) != 0) {
+        arena_die("Failed to initialize chunk arena");
+    }
+}
+
+static int arena_class_index(size_t size) {
+    if (size <= ARENA_MIN_SIZE) return 0;
+
+    /* 2^k < size <= 2^(k+1); the midpoint class 3 * 2^(k-1) sits between */
+    int k = 63 - __builtin_clzll((unsigned long long)(size - 1));
+    int pow2_class = 2 * (k - 5);
+    return size <= ((size_t)3 << (k - 1)) ? pow2_class + 1 : pow2_class + 2;
+}
+
+static size_t arena_class_size(int index) {
+    return (index & 1) ? (size_t)48 << (index >> 1) : (size_t)32 << (index >> 1);
+}
+
+static size_t arena_page_round(size_t size) {
+    const size_t page = 4096;
+    return (size + page - 1) & ~(page - 1);
+}
+
+static void *arena_map(size_t size, bool huge) {
+    void *ptr = MAP_FAILED;
+#if ARENA_HUGE_PAGES
+    if (huge) {
+        ptr = mmap(NULL, size, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    }
+#endif
+    if (ptr == MAP_FAILED) {
+        ptr = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (ptr == MAP_FAILED) arena_die("Failed to map chunk arena memory");
+#if ARENA_HUGE_PAGES
+        /* No reserved huge pages: ask for transparent ones instead */
+        if (huge) madvise(ptr, size, MADV_HUGEPAGE);
+#endif
+    }
+#if !ARENA_HUGE_PAGES
+    (void)huge;
+#endif
+
+    atomic_fetch_add_explicit(&arena.reserved, size, memory_order_relaxed);
+    atomic_fetch_add_explicit(&arena.system_allocs, 1, memory_order_relaxed);
+    return ptr;
+}
+
+/* Carves a slab of `size`-byte blocks from the current region and links them
+ * into a list; the region's unusable tail is dropped when a new one starts */
+static ArenaBlock *arena_carve_slab(size_t size) {
+    size_t count = ARENA_SLAB_SIZE / size;
+    if (count == 0) count = 1;
+
+    pthread_mutex_lock(&arena.region_lock);
+    if (!arena.region || ARENA_REGION_SIZE - arena.region_used < size) {
+        arena.region = arena_map(ARENA_REGION_SIZE, true);
+        arena.region_used = 0;
+    }
+    size_t fit = (ARENA_REGION_SIZE - arena.region_used) / size;
+    if (count > fit) count = fit;
+
+    uint8_t *base = arena.region + arena.region_used;
+    arena.region_used += count * size;
+    pthread_mutex_unlock(&arena.region_lock);
+
+    for (size_t i = 0; i + 1 < count; ++i) {
+        ((ArenaBlock *)(void *)(base + i * size))->next = (ArenaBlock *)(void *)(base + (i + 1) * size);
+    }
+    ((ArenaBlock *)(void *)(base + (count - 1) * size))->next = NULL;
+    return (ArenaBlock *)(void *)base;
+}
+
+static void arena_track(size_t size, bool allocated) {
+    if (!allocated) {
+        atomic_fetch_sub_explicit(&arena.in_use, size, memory_order_relaxed);
+        return;
+    }
+
+    size_t now = atomic_fetch_add_explicit(&arena.in_use, size, memory_order_relaxed) + size;
+    size_t peak = atomic_load_explicit(&arena.peak_in_use, memory_order_relaxed);
+    while (now > peak &&
+           !atomic_compare_exchange_weak_explicit(&arena.peak_in_use, &peak, now,
+                                                  memory_order_relaxed, memory_order_relaxed)) {
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+/* Allocation                                                                 */
+/* -------------------------------------------------------------------------- */
+
+void *arena_alloc(size_t size) {
+    if (size == 0) return NULL;
+    pthread_once(&arena.once, arena_init_once);
+
+    if (size > ARENA_MAX_SIZE) {
+        size_t mapped = arena_page_round(size);
+        arena_track(mapped, true);
+        return arena_map(mapped, false);
+    }
+
+    int index = arena_class_index(size);
+    ArenaClass *size_class = &arena.classes[index];
+
+    pthread_mutex_lock(&size_class->lock);
+    if (!size_class->free_list) size_class->free_list = arena_carve_slab(arena_class_size(index));
+    ArenaBlock *block = size_class->free_list;
+    size_class->free_list = block->next;
+    pthread_mutex_unlock(&size_class->lock);
+
+    arena_track(arena_class_size(index), true);
+    return block;
+}
+
+void arena_free(void *ptr, size_t size) {
+    if (!ptr) return;
+
+    if (size > ARENA_MAX_SIZE) {
+        size_t mapped = arena_page_round(size);
+        munmap(ptr, mapped);
+        arena_track(mapped, false);
+        atomic_fetch_sub_explicit(&arena.reserved, mapped, memory_order_relaxed);
+        return;
+    }
+
+    int index = arena_class_index(size);
+    ArenaClass *size_class = &arena.classes[index];
+    ArenaBlock *block = ptr;
+
+    pthread_mutex_lock(&size_class->lock);
+    block->next = size_class->free_list;
+    size_class->free_list = block;
+    pthread_mutex_unlock(&size_class->lock);
+
+    arena_track(arena_class_size(index), false);
+}
+
+void *arena_realloc(void *ptr, size_t old_size, size_t new_size) {
+    if (!ptr) return arena_alloc(new_size);
+
+    /* Sizes within one class already share a block */
+    if (old_size <= ARENA_MAX_SIZE && new_size <= ARENA_MAX_SIZE && new_size > 0 &&
+        arena_class_index(old_size) == arena_class_index(new_size)) {
+        return ptr;
+    }
+
+    void *moved = arena_alloc(new_size);
+    if (moved) memcpy(moved, ptr, old_size < new_size ? old_size : new_size);
+    arena_free(ptr, old_size);
+    return moved;
+}
+
+void arena_get_stats(ArenaStats *stats) {
+    stats->in_use = atomic_load_explicit(&arena.in_use, memory_order_relaxed);
+    stats->peak_in_use = atomic_load_explicit(&arena.peak_in_use, memory_order_relaxed);
+    stats->reserved = atomic_load_explicit(&arena.reserved, memory_order_relaxed);
+    stats->system_allocs = atomic_load_explicit(&arena.system_allocs, memory_order_relaxed);
+}
@@ -0,0 +1,45 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+
+/* Chunk memory arena: section voxels, face lists, meshes and the chunks
+ * themselves are carved from large regions into size classes and recycled
+ * through per-class free lists, so streaming in steady state reuses buffers
+ * instead of going back to malloc. Safe to use from any thread. */
+
+/* Back regions with huge pages: 1 = MAP_HUGETLB, falling back to transparent
+ * huge pages when none are reserved. Build with -DARENA_HUGE_PAGES=1. */
+#ifndef ARENA_HUGE_PAGES
+#define ARENA_HUGE_PAGES 0
+#endif
+
+/* Print the arena's high-water mark when the game exits, for sizing work.
+ * Build with -DARENA_REPORT_STATS=1. */
+#ifndef ARENA_REPORT_STATS
+#define ARENA_REPORT_STATS 0
+#endif
+
+typedef struct {
+    size_t in_use;          /* Bytes handed out, rounded up to their size class */
+    size_t peak_in_use;     /* High-water mark of in_use */
+    size_t reserved;        /* Bytes mapped from the system */
+    size_t system_allocs;   /* Region and oversized mappings made so far */
+} ArenaStats;
+
+/* -------------------------------------------------------------------------- */
+/* Public API                                                                 */
+/* -------------------------------------------------------------------------- */
+
+/* Blocks are 16-byte aligned; a size of 0 returns NULL */
+void *arena_alloc(size_t size);
+
+/* Callers pass back the size they allocated; NULL is ignored */
+void arena_free(void *ptr, size_t size);
+
+/* Moves to a block of new_size, keeping the first min(old, new) bytes */
+void *arena_realloc(void *ptr, size_t old_size, size_t new_size);
+
+void arena_get_stats(ArenaStats *stats);
+
+#endif /* ARENA_H */
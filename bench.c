@@ -0,0 +1,155 @@
+#include <dirent.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "arena.h"
+#include "world.h"
+
+/* Chunk cost benchmark, run by `make bench` once per build height. Streams
+ * the square around the origin, meshes it in both modes and saves a fixed
+ * set of edits, then prints one line per WORLD_MAX_Y setting. Resident
+ * memory is read from /proc, so it runs on Linux only. */
+
+#define BENCH_REBUILD_ROUNDS 20
+
+/* -------------------------------------------------------------------------- */
+/* Helpers                                                                    */
+/* -------------------------------------------------------------------------- */
+
+static double bench_now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1000.0 + (double)ts.tv_nsec / 1.0e6;
+}
+
+static long bench_resident_kb(void) {
+    long pages = 0, resident = 0;
+    FILE *f = fopen("/proc/self/statm", "r");
+    if (!f) return 0;
+    if (fscanf(f, "%ld %ld", &pages, &resident) != 2) resident = 0;
+    fclose(f);
+    return resident * (sysconf(_SC_PAGESIZE) / 1024);
+}
+
+/* Total size of the files in dir; with `remove_files` they are deleted */
+static long bench_dir_size(const char *dir, bool remove_files) {
+    DIR *d = opendir(dir);
+    if (!d) return 0;
+    
+    long total = 0;
+    char path[512];
+    for (struct dirent *entry; (entry = readdir(d)) != NULL;) {
+        if (entry->d_name[0] == '.') continue;
+        snprintf(path, sizeof(path), "%s/%s", dir, entry->d_name);
+        
+        struct stat st;
+        if (stat(path, &st) == 0) total += (long)st.st_size;
+        if (remove_files) unlink(path);
+    }
+    closedir(d);
+    return total;
+}
+
+static void bench_settle(World *world) {
+    do {
+        world_update_chunks(world, vec3(0.0f, 10.0f, 0.0f), NULL);
+    } while (world->in_flight_count || world->load_queue_count);
+}
+
+/* Best time over BENCH_REBUILD_ROUNDS rebuilds of every meshed chunk, in us
+ * per chunk */
+static double bench_rebuild_us(World *world, WorldRenderTotals *totals) {
+    world_prepare_render(world, totals);
+    
+    int meshed = 0;
+    double best = 1.0e30;
+    for (int round = 0; round < BENCH_REBUILD_ROUNDS; ++round) {
+        meshed = 0;
+        for (int i = 0; i < world->chunk_count; ++i) {
+            Chunk *chunk = world->chunks[i];
+            if (chunk->state == CHUNK_STATE_GENERATED) continue;
+            chunk->render_dirty = true;
+            ++meshed;
+        }
+        
+        double start = bench_now_ms();
+        world_prepare_render(world, totals);
+        double elapsed = bench_now_ms() - start;
+        if (elapsed < best) best = elapsed;
+    }
+    return meshed > 0 ? best * 1000.0 / meshed : 0.0;
+}
+
+/* -------------------------------------------------------------------------- */
+/* Main                                                                       */
+/* -------------------------------------------------------------------------- */
+
+int main(void) {
+    char dir[] = "/tmp/voxel-bench-XXXXXX";
+    if (!mkdtemp(dir)) {
+        fprintf(stderr, "Error: Failed to create benchmark save directory\n");
+        return EXIT_FAILURE;
+    }
+    
+    static WorldSave save;
+    static World world;
+    world_save_init(&save, dir);
+    
+    long resident_before = bench_resident_kb();
+    world_init(&world, &save);
+    world.stream_budget_ms = 1.0e9f;
+    
+    double load_start = bench_now_ms();
+    bench_settle(&world);
+    double load_ms = bench_now_ms() - load_start;
+    
+    WorldRenderTotals faces, quads;
+    world_set_greedy_meshing(&world, false);
+    double faces_us = bench_rebuild_us(&world, &faces);
+    world_set_greedy_meshing(&world, true);
+    double greedy_us = bench_rebuild_us(&world, &quads);
+    long resident_kb = bench_resident_kb() - resident_before;
+    
+    /* A 4x4 slab near the top of every meshed chunk, then one synced save */
+    int meshed = 0;
+    int slab_y = WORLD_MAX_Y - 1;
+    for (int i = 0; i < world.chunk_count; ++i) {
+        Chunk *chunk = world.chunks[i];
+        if (chunk->state == CHUNK_STATE_GENERATED) continue;
+        ++meshed;
+        for (int dz = 0; dz < 4; ++dz) {
+            for (int dx = 0; dx < 4; ++dx) {
+                IVec3 pos = {chunk->cx * CHUNK_SIZE + 6 + dx, slab_y, chunk->cz * CHUNK_SIZE + 6 + dz};
+                world_add_block(&world, pos, BLOCK_STONE);
+            }
+        }
+    }
+    
+    double save_start = bench_now_ms();
+    world_save_edited_chunks(&world);
+    world_save_flush(&save);
+    world_save_sync(&save);
+    double save_ms = bench_now_ms() - save_start;
+    
+    ArenaStats arena_stats;
+    arena_get_stats(&arena_stats);
+    int chunk_count = world.chunk_count;
+    
+    world_destroy(&world);
+    world_save_destroy(&save);
+    long save_bytes = bench_dir_size(dir, true);
+    rmdir(dir);
+    
+    printf("height %3d: %d chunks, %d meshed, load %.1f ms | rss %.1f KB/chunk, arena peak %.1f KB/chunk"
+           " | rebuild faces %.1f us/chunk (%d faces), greedy %.1f us/chunk (%d quads)"
+           " | save %d edited chunks %.1f ms, %ld B\n",
+           CHUNK_HEIGHT, chunk_count, meshed, load_ms,
+           (double)resident_kb / chunk_count, (double)arena_stats.peak_in_use / 1024.0 / chunk_count,
+           faces_us, faces.face_total, greedy_us, quads.mesh_index_total / 6,
+           meshed, save_ms, save_bytes);
+    return EXIT_SUCCESS;
+}
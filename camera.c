@@ -28,6 +28,8 @@ void camera_init(Camera *cam) {
     cam->pitch = 0.0f;
     cam->movement_speed = 6.0f;
     cam->mouse_sensitivity = 0.1f;
+    cam->fov = 55.0f;
+    cam->aspect = 16.0f / 9.0f;
     camera_update_axes(cam);
 }
 
@@ -56,4 +58,32 @@ void camera_reset_view(Camera *cam) {
     cam->yaw = -90.0f;
     cam->pitch = 0.0f;
     camera_update_axes(cam);
+}
+
+void camera_set_aspect(Camera *cam, uint32_t width, uint32_t height) {
+    if (!cam || width == 0 || height == 0) return;
+    cam->aspect = (float)width / (float)height;
+}
+
+/* Side planes only; near/far are irrelevant at streaming distances */
+bool camera_box_visible(const Camera *cam, Vec3 min, Vec3 max) {
+    float tan_y = tanf(DEG_TO_RAD(cam->fov) * 0.5f);
+    float tan_x = tan_y * cam->aspect;
+
+    /* Inward plane normals through the eye: front * tan(half angle) -/+ side axis */
+    Vec3 normals[4] = {
+        vec3_sub(vec3_scale(cam->front, tan_x), cam->right),
+        vec3_add(vec3_scale(cam->front, tan_x), cam->right),
+        vec3_sub(vec3_scale(cam->front, tan_y), cam->up),
+        vec3_add(vec3_scale(cam->front, tan_y), cam->up)
+    };
+
+    for (int i = 0; i < 4; ++i) {
+        Vec3 n = normals[i];
+        Vec3 corner = vec3(n.x >= 0.0f ? max.x : min.x,
+                           n.y >= 0.0f ? max.y : min.y,
+                           n.z >= 0.0f ? max.z : min.z);
+        if (vec3_dot(vec3_sub(corner, cam->position), n) < 0.0f) return false;
+    }
+    return true;
 }
\ No newline at end of file
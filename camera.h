@@ -15,6 +15,8 @@ typedef struct Camera {
     float pitch;
     float movement_speed;
     float mouse_sensitivity;
+    float fov;
+    float aspect;
 } Camera;
 
 void camera_init(Camera *cam);
@@ -22,5 +24,7 @@ void camera_process_mouse(Camera *cam, float x_offset, float y_offset);
 Mat4 camera_view_matrix(Camera *cam);
 void camera_follow_player(Camera *cam, const Player *player);
 void camera_reset_view(Camera *cam);
+void camera_set_aspect(Camera *cam, uint32_t width, uint32_t height);
+bool camera_box_visible(const Camera *cam, Vec3 min, Vec3 max);
 
 #endif /* CAMERA_H */
\ No newline at end of file
@@ -20,7 +20,7 @@
 typedef struct {
     Vec3 position;
     Vec3 scale;
-    uint32_t type;
+    BlockId type;
     float rot_x;
     float rot_y;
 } EntityRenderBlock;
@@ -53,9 +53,9 @@ static bool zombie_find_ground(World *world, Vec3 pos, float *out_ground_y) {
             Vec3 test = vec3(pos.x + offsets[xi], pos.y - 0.51f, pos.z + offsets[zi]);
             IVec3 cell = world_to_cell(test);
 
-            uint8_t type;
+            BlockId type;
             if (!world_get_block_type(world, cell, &type)) continue;
-            if (type == BLOCK_WATER) continue;
+            if (!block_is_solid(type)) continue;
 
             float top = (float)cell.y + 0.5f;
             if (top > ground_y) ground_y = top;
@@ -81,9 +81,9 @@ static bool zombie_find_ground_within(World *world, Vec3 pos, int max_drop_block
                 Vec3 test = vec3(pos.x + offsets[xi], sample_y, pos.z + offsets[zi]);
                 IVec3 cell = world_to_cell(test);
 
-                uint8_t type;
+                BlockId type;
                 if (!world_get_block_type(world, cell, &type)) continue;
-                if (type == BLOCK_WATER) continue;
+                if (!block_is_solid(type)) continue;
 
                 float top = (float)cell.y + 0.5f;
                 if (top > ground_y) ground_y = top;
@@ -132,9 +132,9 @@ static void zombie_resolve_horizontal_collision(World *world, Vec3 *pos) {
             for (int y = min_y; y <= max_y; ++y) {
                 if (!world_y_in_bounds(y)) continue;
                 for (int z = min_z; z <= max_z; ++z) {
-                    uint8_t type;
+                    BlockId type;
                     if (!world_get_block_type(world, (IVec3){x, y, z}, &type)) continue;
-                    if (type == BLOCK_WATER) continue;
+                    if (!block_is_solid(type)) continue;
 
                     AABB block_aabb = cell_aabb((IVec3){x, y, z});
 
@@ -394,7 +394,7 @@ uint32_t entity_write_render_blocks(const Entity *entity, void *out_data,
         f[0] = blocks[i].position.x;
         f[1] = blocks[i].position.y;
         f[2] = blocks[i].position.z;
-        ((uint32_t *)dest)[3] = blocks[i].type;
+        ((uint32_t *)dest)[3] = block_texture(blocks[i].type);
         f[4] = blocks[i].scale.x;
         f[5] = blocks[i].scale.y;
         f[6] = blocks[i].scale.z;
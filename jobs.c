@@ -0,0 +1,239 @@
+#include "jobs.h"
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+/* -------------------------------------------------------------------------- */
+/* JobPool Structure                                                          */
+/* -------------------------------------------------------------------------- */
+
+typedef struct {
+    JobFn fn;
+    void *arg;
+} Job;
+
+struct JobPool {
+    pthread_t *threads;
+    int thread_count;
+
+    pthread_mutex_t lock;
+    pthread_cond_t available;
+    bool stopping;
+
+    /* Circular FIFO of pending jobs */
+    Job *jobs;
+    int head;
+    int count;
+    int capacity;
+};
+
+/* -------------------------------------------------------------------------- */
+/* Error Handling                                                             */
+/* -------------------------------------------------------------------------- */
+
+static void jobs_die(const char *message) {
+    fprintf(stderr, "Error: %s\n", message);
+    exit(EXIT_FAILURE);
+}
+
+/* -------------------------------------------------------------------------- */
+/* Queue Helpers                                                              */
+/* -------------------------------------------------------------------------- */
+
+static void job_queue_grow(JobPool *pool) {
+    int new_cap = pool->capacity > 0 ? pool->capacity * 2 : 64;
+    Job *new_jobs = malloc((size_t)new_cap * sizeof(Job));
+    if (!new_jobs) jobs_die("Failed to grow job queue");
+
+    for (int i = 0; i < pool->count; ++i) {
+        new_jobs[i] = pool->jobs[(pool->head + i) % pool->capacity];
+    }
+
+    free(pool->jobs);
+    pool->jobs = new_jobs;
+    pool->head = 0;
+    pool->capacity = new_cap;
+}
+
+static void *job_worker_main(void *arg) {
+    JobPool *pool = arg;
+
+    pthread_mutex_lock(&pool->lock);
+    for (;;) {
+        while (pool->count == 0 && !pool->stopping) {
+            pthread_cond_wait(&pool->available, &pool->lock);
+        }
+        if (pool->count == 0) break;
+
+        Job job = pool->jobs[pool->head];
+        pool->head = (pool->head + 1) % pool->capacity;
+        pool->count--;
+
+        pthread_mutex_unlock(&pool->lock);
+        job.fn(job.arg);
+        pthread_mutex_lock(&pool->lock);
+    }
+    pthread_mutex_unlock(&pool->lock);
+
+    return NULL;
+}
+
+/* -------------------------------------------------------------------------- */
+/* JobPool Creation & Destruction                                             */
+/* -------------------------------------------------------------------------- */
+
+JobPool *job_pool_create(int thread_count) {
+    if (thread_count <= 0) {
+        long cores = sysconf(_SC_NPROCESSORS_ONLN);
+        thread_count = cores > 1 ? (int)cores - 1 : 1;
+    }
+
+    JobPool *pool = calloc(1, sizeof(*pool));
+    if (!pool) jobs_die("Failed to allocate job pool");
+
+    pool->threads = calloc((size_t)thread_count, sizeof(pthread_t));
+    if (!pool->threads) jobs_die("Failed to allocate worker threads");
+
+    if (pthread_mutex_init(&pool->lock, NULL) != 0 ||
+        pthread_cond_init(&pool->available, NULL) != 0) {
+        jobs_die("Failed to initialize job pool");
+    }
+
+    for (int i = 0; i < thread_count; ++i) {
+        if (pthread_create(&pool->threads[i], NULL, job_worker_main, pool) != 0) {
+            jobs_die("Failed to start worker thread");
+        }
+        pool->thread_count++;
+    }
+
+    return pool;
+}
+
+void job_pool_destroy(JobPool *pool) {
+    if (!pool) return;
+
+    pthread_mutex_lock(&pool->lock);
+    pool->stopping = true;
+    pthread_cond_broadcast(&pool->available);
+    pthread_mutex_unlock(&pool->lock);
+
+    for (int i = 0; i < pool->thread_count; ++i) {
+        pthread_join(pool->threads[i], NULL);
+    }
+
+    pthread_cond_destroy(&pool->available);
+    pthread_mutex_destroy(&pool->lock);
+    free(pool->jobs);
+    free(pool->threads);
+    free(pool);
+}
+
+/* -------------------------------------------------------------------------- */
+/* Submission                                                                 */
+/* -------------------------------------------------------------------------- */
+
+void job_pool_submit(JobPool *pool, JobFn fn, void *arg) {
+    pthread_mutex_lock(&pool->lock);
+
+    if (pool->count == pool->capacity) job_queue_grow(pool);
+    pool->jobs[(pool->head + pool->count) % pool->capacity] = (Job){.fn = fn, .arg = arg};
+    pool->count++;
+
+    pthread_cond_signal(&pool->available);
+    pthread_mutex_unlock(&pool->lock);
+}
+
+/* -------------------------------------------------------------------------- */
+/* Parallel For                                                               */
+/* -------------------------------------------------------------------------- */
+
+/* Shared by the caller and its helper jobs; freed by whoever drops the last
+ * reference, since helpers may start after the caller has already returned */
+typedef struct {
+    JobRangeFn fn;
+    void *ctx;
+    int count;
+    atomic_int next;
+    atomic_int refs;
+
+    pthread_mutex_t lock;
+    pthread_cond_t finished;
+    int done;
+} ParallelBatch;
+
+static void parallel_batch_release(ParallelBatch *batch) {
+    if (atomic_fetch_sub_explicit(&batch->refs, 1, memory_order_acq_rel) != 1) return;
+
+    pthread_cond_destroy(&batch->finished);
+    pthread_mutex_destroy(&batch->lock);
+    free(batch);
+}
+
+static void parallel_batch_drain(ParallelBatch *batch) {
+    int completed = 0;
+    for (;;) {
+        int i = atomic_fetch_add_explicit(&batch->next, 1, memory_order_relaxed);
+        if (i >= batch->count) break;
+        batch->fn(batch->ctx, i);
+        completed++;
+    }
+    if (completed == 0) return;
+
+    pthread_mutex_lock(&batch->lock);
+    batch->done += completed;
+    if (batch->done == batch->count) pthread_cond_signal(&batch->finished);
+    pthread_mutex_unlock(&batch->lock);
+}
+
+static void parallel_batch_job(void *arg) {
+    ParallelBatch *batch = arg;
+    parallel_batch_drain(batch);
+    parallel_batch_release(batch);
+}
+
+void job_pool_parallel_for(JobPool *pool, int count, JobRangeFn fn, void *ctx) {
+    if (count <= 0) return;
+
+    int helpers = pool ? pool->thread_count : 0;
+    if (helpers > count - 1) helpers = count - 1;
+    if (helpers == 0) {
+        for (int i = 0; i < count; ++i) fn(ctx, i);
+        return;
+    }
+
+    ParallelBatch *batch = malloc(sizeof(*batch));
+    if (!batch) jobs_die("Failed to allocate parallel batch");
+
+    batch->fn = fn;
+    batch->ctx = ctx;
+    batch->count = count;
+    batch->done = 0;
+    atomic_init(&batch->next, 0);
+    atomic_init(&batch->refs, helpers + 1);
+    if (pthread_mutex_init(&batch->lock, NULL) != 0 ||
+        pthread_cond_init(&batch->finished, NULL) != 0) {
+        jobs_die("Failed to initialize parallel batch");
+    }
+
+    for (int i = 0; i < helpers; ++i) {
+        job_pool_submit(pool, parallel_batch_job, batch);
+    }
+
+    /* The caller works too, then waits only for indices already claimed */
+    parallel_batch_drain(batch);
+
+    pthread_mutex_lock(&batch->lock);
+    while (batch->done < batch->count) {
+        pthread_cond_wait(&batch->finished, &batch->lock);
+    }
+    pthread_mutex_unlock(&batch->lock);
+
+    parallel_batch_release(batch);
+}
+
+int job_pool_thread_count(const JobPool *pool) {
+    return pool ? pool->thread_count : 0;
+}
@@ -0,0 +1,31 @@
+#ifndef JOBS_H
+#define JOBS_H
+
+#include <stdbool.h>
+
+typedef struct JobPool JobPool;
+
+typedef void (*JobFn)(void *arg);
+typedef void (*JobRangeFn)(void *ctx, int index);
+
+/* -------------------------------------------------------------------------- */
+/* Public API                                                                 */
+/* -------------------------------------------------------------------------- */
+
+/* Create a pool of worker threads; thread_count <= 0 uses one per spare core */
+JobPool *job_pool_create(int thread_count);
+
+/* Run every queued job to completion, then join the workers */
+void job_pool_destroy(JobPool *pool);
+
+/* Queue fn(arg) to run on a worker thread (FIFO) */
+void job_pool_submit(JobPool *pool, JobFn fn, void *arg);
+
+/* Call fn(ctx, i) for every i in [0, count) on the workers and the calling
+ * thread; returns once all calls have finished. Workers busy with earlier jobs
+ * join in late or not at all, so this never waits on unrelated work. */
+void job_pool_parallel_for(JobPool *pool, int count, JobRangeFn fn, void *ctx);
+
+int job_pool_thread_count(const JobPool *pool);
+
+#endif /* JOBS_H */
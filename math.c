@@ -1,6 +1,10 @@
 #include "math.h"
 #include <math.h>
 
+#if defined(__AVX2__) || defined(__SSE4_1__)
+#include <immintrin.h>
+#endif
+
 /* -------------------------------------------------------------------------- */
 /* Vector Operations                                                          */
 /* -------------------------------------------------------------------------- */
@@ -115,17 +119,14 @@ static inline float fade(float t) {
     return t * t * t * (t * (t * 6.0f - 15.0f) + 10.0f);
 }
 
+static const float GRADIENT_X[8] = {1.0f, -1.0f, 0.0f, 0.0f, 0.70710678f, -0.70710678f, 0.70710678f, -0.70710678f};
+static const float GRADIENT_Y[8] = {0.0f, 0.0f, 1.0f, -1.0f, 0.70710678f, 0.70710678f, -0.70710678f, -0.70710678f};
+
 static float gradient_dot(int ix, int iy, float x, float y, uint32_t seed) {
-    static const Vec2 gradients[8] = {
-        { 1.0f,  0.0f}, {-1.0f,  0.0f}, { 0.0f,  1.0f}, { 0.0f, -1.0f},
-        { 0.70710678f,  0.70710678f}, {-0.70710678f,  0.70710678f},
-        { 0.70710678f, -0.70710678f}, {-0.70710678f, -0.70710678f}
-    };
-    
-    Vec2 g = gradients[hash_2d(ix, iy, seed) & 7u];
+    uint32_t g = hash_2d(ix, iy, seed) & 7u;
     float dx = x - (float)ix;
     float dy = y - (float)iy;
-    return dx * g.x + dy * g.y;
+    return dx * GRADIENT_X[g] + dy * GRADIENT_Y[g];
 }
 
 float perlin2d(float x, float y, uint32_t seed) {
@@ -152,4 +153,312 @@ float fbm2d(float x, float y, int octaves, float lacunarity, float gain, uint32_
     }
     
     return total > 0.0f ? sum / total : sum;
-}
\ No newline at end of file
+}
+
+/* -------------------------------------------------------------------------- */
+/* Batched Noise                                                              */
+/* -------------------------------------------------------------------------- */
+
+/* The vector paths mirror the scalar code operation for operation, lanes
+ * taking the place of single samples; a tail shorter than one vector falls
+ * back to the scalar functions */
+
+#if defined(__AVX2__)
+
+#define NOISE_LANES 8
+
+static inline __m256i hash_2d_x8(__m256i x, __m256i y, uint32_t seed) {
+    __m256i h = _mm256_add_epi32(_mm256_mullo_epi32(x, _mm256_set1_epi32(374761393)),
+                                 _mm256_mullo_epi32(y, _mm256_set1_epi32(668265263)));
+    h = _mm256_add_epi32(h, _mm256_set1_epi32((int)(seed * 374761393u)));
+    h = _mm256_mullo_epi32(_mm256_xor_si256(h, _mm256_srli_epi32(h, 13)), _mm256_set1_epi32(1274126177));
+    return _mm256_xor_si256(h, _mm256_srli_epi32(h, 16));
+}
+
+static inline __m256 fade_x8(__m256 t) {
+    __m256 inner = _mm256_sub_ps(_mm256_mul_ps(t, _mm256_set1_ps(6.0f)), _mm256_set1_ps(15.0f));
+    inner = _mm256_add_ps(_mm256_mul_ps(t, inner), _mm256_set1_ps(10.0f));
+    return _mm256_mul_ps(_mm256_mul_ps(_mm256_mul_ps(t, t), t), inner);
+}
+
+static inline __m256 lerp_x8(__m256 a, __m256 b, __m256 t) {
+    return _mm256_add_ps(a, _mm256_mul_ps(_mm256_sub_ps(b, a), t));
+}
+
+static inline __m256 gradient_dot_x8(__m256i ix, __m256i iy, __m256 x, __m256 y, uint32_t seed) {
+    __m256i g = _mm256_and_si256(hash_2d_x8(ix, iy, seed), _mm256_set1_epi32(7));
+    __m256 gx = _mm256_permutevar8x32_ps(_mm256_loadu_ps(GRADIENT_X), g);
+    __m256 gy = _mm256_permutevar8x32_ps(_mm256_loadu_ps(GRADIENT_Y), g);
+    __m256 dx = _mm256_sub_ps(x, _mm256_cvtepi32_ps(ix));
+    __m256 dy = _mm256_sub_ps(y, _mm256_cvtepi32_ps(iy));
+    return _mm256_add_ps(_mm256_mul_ps(dx, gx), _mm256_mul_ps(dy, gy));
+}
+
+static inline __m256 perlin2d_x8(__m256 x, __m256 y, uint32_t seed) {
+    __m256 fx = _mm256_floor_ps(x), fy = _mm256_floor_ps(y);
+    __m256i x0 = _mm256_cvttps_epi32(fx), y0 = _mm256_cvttps_epi32(fy);
+    __m256i x1 = _mm256_add_epi32(x0, _mm256_set1_epi32(1));
+    __m256i y1 = _mm256_add_epi32(y0, _mm256_set1_epi32(1));
+    __m256 sx = fade_x8(_mm256_sub_ps(x, fx));
+    __m256 sy = fade_x8(_mm256_sub_ps(y, fy));
+    
+    __m256 n00 = gradient_dot_x8(x0, y0, x, y, seed);
+    __m256 n10 = gradient_dot_x8(x1, y0, x, y, seed);
+    __m256 n01 = gradient_dot_x8(x0, y1, x, y, seed);
+    __m256 n11 = gradient_dot_x8(x1, y1, x, y, seed);
+    
+    return lerp_x8(lerp_x8(n00, n10, sx), lerp_x8(n01, n11, sx), sy);
+}
+
+static int perlin2d_batch_simd(const float *xs, const float *ys, float *out, int n, uint32_t seed) {
+    int i = 0;
+    for (; i + NOISE_LANES <= n; i += NOISE_LANES) {
+        _mm256_storeu_ps(&out[i], perlin2d_x8(_mm256_loadu_ps(&xs[i]), _mm256_loadu_ps(&ys[i]), seed));
+    }
+    return i;
+}
+
+static int fbm2d_batch_simd(const float *xs, const float *ys, float *out, int n,
+                            int octaves, float lacunarity, float gain, uint32_t seed) {
+    int i = 0;
+    for (; i + NOISE_LANES <= n; i += NOISE_LANES) {
+        __m256 x = _mm256_loadu_ps(&xs[i]), y = _mm256_loadu_ps(&ys[i]);
+        __m256 sum = _mm256_setzero_ps();
+        float amplitude = 1.0f, frequency = 1.0f, total = 0.0f;
+        
+        for (int o = 0; o < octaves; ++o) {
+            __m256 f = _mm256_set1_ps(frequency);
+            __m256 p = perlin2d_x8(_mm256_mul_ps(x, f), _mm256_mul_ps(y, f), seed + (uint32_t)o * 1013u);
+            sum = _mm256_add_ps(sum, _mm256_mul_ps(p, _mm256_set1_ps(amplitude)));
+            total += amplitude;
+            amplitude *= gain;
+            frequency *= lacunarity;
+        }
+        
+        _mm256_storeu_ps(&out[i], total > 0.0f ? _mm256_div_ps(sum, _mm256_set1_ps(total)) : sum);
+    }
+    return i;
+}
+
+#elif defined(__SSE4_1__)
+
+#define NOISE_LANES 4
+
+static inline __m128i hash_2d_x4(__m128i x, __m128i y, uint32_t seed) {
+    __m128i h = _mm_add_epi32(_mm_mullo_epi32(x, _mm_set1_epi32(374761393)),
+                              _mm_mullo_epi32(y, _mm_set1_epi32(668265263)));
+    h = _mm_add_epi32(h, _mm_set1_epi32((int)(seed * 374761393u)));
+    h = _mm_mullo_epi32(_mm_xor_si128(h, _mm_srli_epi32(h, 13)), _mm_set1_epi32(1274126177));
+    return _mm_xor_si128(h, _mm_srli_epi32(h, 16));
+}
+
+static inline __m128 fade_x4(__m128 t) {
+    __m128 inner = _mm_sub_ps(_mm_mul_ps(t, _mm_set1_ps(6.0f)), _mm_set1_ps(15.0f));
+    inner = _mm_add_ps(_mm_mul_ps(t, inner), _mm_set1_ps(10.0f));
+    return _mm_mul_ps(_mm_mul_ps(_mm_mul_ps(t, t), t), inner);
+}
+
+static inline __m128 lerp_x4(__m128 a, __m128 b, __m128 t) {
+    return _mm_add_ps(a, _mm_mul_ps(_mm_sub_ps(b, a), t));
+}
+
+static inline __m128 gradient_dot_x4(__m128i ix, __m128i iy, __m128 x, __m128 y, uint32_t seed) {
+    /* No 8-entry lane permute before AVX2, so the gradient is assembled from
+     * its index bits: bit 2 picks a diagonal, bit 1 the axis (or the sign of
+     * y on diagonals), bit 0 negates the first nonzero component */
+    __m128i g = _mm_and_si128(hash_2d_x4(ix, iy, seed), _mm_set1_epi32(7));
+    __m128 diagonal = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(g, _mm_set1_epi32(4)), _mm_set1_epi32(4)));
+    __m128 along_y = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(g, _mm_set1_epi32(2)), _mm_set1_epi32(2)));
+    __m128 sign_x = _mm_castsi128_ps(_mm_slli_epi32(g, 31));
+    __m128 sign_y = _mm_castsi128_ps(_mm_slli_epi32(_mm_srli_epi32(g, 1), 31));
+    __m128 one = _mm_set1_ps(1.0f), diag = _mm_set1_ps(0.70710678f), zero = _mm_setzero_ps();
+    
+    __m128 gx = _mm_xor_ps(_mm_blendv_ps(_mm_blendv_ps(one, zero, along_y), diag, diagonal), sign_x);
+    __m128 gy = _mm_blendv_ps(_mm_blendv_ps(zero, _mm_xor_ps(one, sign_x), along_y),
+                              _mm_xor_ps(diag, sign_y), diagonal);
+    __m128 dx = _mm_sub_ps(x, _mm_cvtepi32_ps(ix));
+    __m128 dy = _mm_sub_ps(y, _mm_cvtepi32_ps(iy));
+    return _mm_add_ps(_mm_mul_ps(dx, gx), _mm_mul_ps(dy, gy));
+}
+
+static inline __m128 perlin2d_x4(__m128 x, __m128 y, uint32_t seed) {
+    __m128 fx = _mm_floor_ps(x), fy = _mm_floor_ps(y);
+    __m128i x0 = _mm_cvttps_epi32(fx), y0 = _mm_cvttps_epi32(fy);
+    __m128i x1 = _mm_add_epi32(x0, _mm_set1_epi32(1));
+    __m128i y1 = _mm_add_epi32(y0, _mm_set1_epi32(1));
+    __m128 sx = fade_x4(_mm_sub_ps(x, fx));
+    __m128 sy = fade_x4(_mm_sub_ps(y, fy));
+    
+    __m128 n00 = gradient_dot_x4(x0, y0, x, y, seed);
+    __m128 n10 = gradient_dot_x4(x1, y0, x, y, seed);
+    __m128 n01 = gradient_dot_x4(x0, y1, x, y, seed);
+    __m128 n11 = gradient_dot_x4(x1, y1, x, y, seed);
+    
+    return lerp_x4(lerp_x4(n00, n10, sx), lerp_x4(n01, n11, sx), sy);
+}
+
+static int perlin2d_batch_simd(const float *xs, const float *ys, float *out, int n, uint32_t seed) {
+    int i = 0;
+    for (; i + NOISE_LANES <= n; i += NOISE_LANES) {
+        _mm_storeu_ps(&out[i], perlin2d_x4(_mm_loadu_ps(&xs[i]), _mm_loadu_ps(&ys[i]), seed));
+    }
+    return i;
+}
+
+static int fbm2d_batch_simd(const float *xs, const float *ys, float *out, int n,
+                            int octaves, float lacunarity, float gain, uint32_t seed) {
+    int i = 0;
+    for (; i + NOISE_LANES <= n; i += NOISE_LANES) {
+        __m128 x = _mm_loadu_ps(&xs[i]), y = _mm_loadu_ps(&ys[i]);
+        __m128 sum = _mm_setzero_ps();
+        float amplitude = 1.0f, frequency = 1.0f, total = 0.0f;
+        
+        for (int o = 0; o < octaves; ++o) {
+            __m128 f = _mm_set1_ps(frequency);
+            __m128 p = perlin2d_x4(_mm_mul_ps(x, f), _mm_mul_ps(y, f), seed + (uint32_t)o * 1013u);
+            sum = _mm_add_ps(sum, _mm_mul_ps(p, _mm_set1_ps(amplitude)));
+            total += amplitude;
+            amplitude *= gain;
+            frequency *= lacunarity;
+        }
+        
+        _mm_storeu_ps(&out[i], total > 0.0f ? _mm_div_ps(sum, _mm_set1_ps(total)) : sum);
+    }
+    return i;
+}
+
+#else
+
+static int perlin2d_batch_simd(const float *xs, const float *ys, float *out, int n, uint32_t seed) {
+    (void)xs; (void)ys; (void)out; (void)n; (void)seed;
+    return 0;
+}
+
+static int fbm2d_batch_simd(const float *xs, const float *ys, float *out, int n,
+                            int octaves, float lacunarity, float gain, uint32_t seed) {
+    (void)xs; (void)ys; (void)out; (void)n; (void)octaves; (void)lacunarity; (void)gain; (void)seed;
+    return 0;
+}
+
+#endif
+
+void perlin2d_batch(const float *xs, const float *ys, float *out, int n, uint32_t seed) {
+    for (int i = perlin2d_batch_simd(xs, ys, out, n, seed); i < n; ++i) {
+        out[i] = perlin2d(xs[i], ys[i], seed);
+    }
+}
+
+void fbm2d_batch(const float *xs, const float *ys, float *out, int n,
+                 int octaves, float lacunarity, float gain, uint32_t seed) {
+    for (int i = fbm2d_batch_simd(xs, ys, out, n, octaves, lacunarity, gain, seed); i < n; ++i) {
+        out[i] = fbm2d(xs[i], ys[i], octaves, lacunarity, gain, seed);
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+/* Grid Noise                                                                 */
+/* -------------------------------------------------------------------------- */
+
+/* Lattice window cached per octave; wider windows fall back to fbm2d */
+#define NOISE_GRID_MAX_LATTICE 1024
+#define NOISE_GRID_MAX_ROWS 64
+
+/* Per-axis part of one octave: lattice cell, offsets into it and fade weight */
+typedef struct {
+    int cell[NOISE_GRID_MAX_AXIS];
+    float d0[NOISE_GRID_MAX_AXIS];   /* coord - cell */
+    float d1[NOISE_GRID_MAX_AXIS];   /* coord - (cell + 1) */
+    float fade[NOISE_GRID_MAX_AXIS];
+    int min_cell;
+    int max_cell;
+} NoiseAxis;
+
+static void noise_axis_init(NoiseAxis *axis, const float *coords, int n, float frequency) {
+    axis->min_cell = INT32_MAX;
+    axis->max_cell = INT32_MIN;
+    for (int i = 0; i < n; ++i) {
+        float v = coords[i] * frequency;
+        int cell = (int)floorf(v);
+        axis->cell[i] = cell;
+        axis->d0[i] = v - (float)cell;
+        axis->d1[i] = v - (float)(cell + 1);
+        axis->fade[i] = fade(v - (float)cell);
+        if (cell < axis->min_cell) axis->min_cell = cell;
+        if (cell > axis->max_cell) axis->max_cell = cell;
+    }
+}
+
+/* Adds one octave of perlin2d over the grid to out, scaled by amplitude.
+ * Interpolating along x first is linear in the y offset, so for one x sample
+ * each lattice row reduces to p + dy * q and the y samples of that column
+ * only look up their two rows. */
+static bool noise_grid_octave(const NoiseAxis *ax, int nx, const NoiseAxis *ay, int ny,
+                              float *out, float amplitude, uint32_t seed) {
+    int width = ax->max_cell - ax->min_cell + 2;
+    int height = ay->max_cell - ay->min_cell + 2;
+    if (height > NOISE_GRID_MAX_ROWS || (int64_t)width * height > NOISE_GRID_MAX_LATTICE) {
+        return false;
+    }
+    
+    /* Gradients of every lattice corner the grid touches, hashed once */
+    float gx[NOISE_GRID_MAX_LATTICE], gy[NOISE_GRID_MAX_LATTICE];
+    for (int ly = 0; ly < height; ++ly) {
+        for (int lx = 0; lx < width; ++lx) {
+            uint32_t g = hash_2d(ax->min_cell + lx, ay->min_cell + ly, seed) & 7u;
+            gx[ly * width + lx] = GRADIENT_X[g];
+            gy[ly * width + lx] = GRADIENT_Y[g];
+        }
+    }
+    
+    int rows[NOISE_GRID_MAX_AXIS];
+    for (int j = 0; j < ny; ++j) rows[j] = ay->cell[j] - ay->min_cell;
+    
+    for (int i = 0; i < nx; ++i) {
+        float p[NOISE_GRID_MAX_ROWS], q[NOISE_GRID_MAX_ROWS];
+        int column = ax->cell[i] - ax->min_cell;
+        for (int r = 0; r < height; ++r) {
+            int k = r * width + column;
+            p[r] = lerp(ax->d0[i] * gx[k], ax->d1[i] * gx[k + 1], ax->fade[i]);
+            q[r] = lerp(gy[k], gy[k + 1], ax->fade[i]);
+        }
+        
+        float *row_out = &out[i * ny];
+        for (int j = 0; j < ny; ++j) {
+            int r = rows[j];
+            float n0 = p[r] + ay->d0[j] * q[r];
+            float n1 = p[r + 1] + ay->d1[j] * q[r + 1];
+            row_out[j] += lerp(n0, n1, ay->fade[j]) * amplitude;
+        }
+    }
+    return true;
+}
+
+void fbm2d_grid(const float *xs, int nx, const float *ys, int ny, float *out,
+                int octaves, float lacunarity, float gain, uint32_t seed) {
+    NoiseAxis ax, ay;
+    float amplitude = 1.0f, frequency = 1.0f, total = 0.0f;
+    
+    for (int i = 0; i < nx * ny; ++i) out[i] = 0.0f;
+    
+    for (int o = 0; o < octaves; ++o) {
+        uint32_t octave_seed = seed + (uint32_t)o * 1013u;
+        noise_axis_init(&ax, xs, nx, frequency);
+        noise_axis_init(&ay, ys, ny, frequency);
+        
+        if (!noise_grid_octave(&ax, nx, &ay, ny, out, amplitude, octave_seed)) {
+            for (int i = 0; i < nx; ++i) {
+                for (int j = 0; j < ny; ++j) {
+                    out[i * ny + j] += perlin2d(xs[i] * frequency, ys[j] * frequency, octave_seed) * amplitude;
+                }
+            }
+        }
+        
+        total += amplitude;
+        amplitude *= gain;
+        frequency *= lacunarity;
+    }
+    
+    if (total > 0.0f) {
+        for (int i = 0; i < nx * ny; ++i) out[i] /= total;
+    }
+}
@@ -52,4 +52,24 @@ uint32_t hash_2d(int x, int y, uint32_t seed);
 float perlin2d(float x, float y, uint32_t seed);
 float fbm2d(float x, float y, int octaves, float lacunarity, float gain, uint32_t seed);
 
+/* out[i] = perlin2d / fbm2d at (xs[i], ys[i]) for i < n, eight samples at a
+ * time with AVX2 or four with SSE4.1 when the build targets them. Vector lanes
+ * round like the scalar code except where the compiler fuses a scalar
+ * multiply-add, so results agree to within NOISE_BATCH_TOLERANCE. */
+#define NOISE_BATCH_TOLERANCE 1e-5f
+
+void perlin2d_batch(const float *xs, const float *ys, float *out, int n, uint32_t seed);
+void fbm2d_batch(const float *xs, const float *ys, float *out, int n,
+                 int octaves, float lacunarity, float gain, uint32_t seed);
+
+/* out[i * ny + j] = fbm2d(xs[i], ys[j], ...) over a grid of at most
+ * NOISE_GRID_MAX_AXIS samples per axis. Floors and fades are taken once per
+ * axis coordinate and each lattice corner is hashed once per octave, shared
+ * by every sample around it; results match fbm2d within
+ * NOISE_BATCH_TOLERANCE. */
+#define NOISE_GRID_MAX_AXIS 64
+
+void fbm2d_grid(const float *xs, int nx, const float *ys, int ny, float *out,
+                int octaves, float lacunarity, float gain, uint32_t seed);
+
 #endif /* MATH_H */
\ No newline at end of file
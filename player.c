@@ -178,7 +178,7 @@ static void draw_number(Vertex *verts, uint32_t *count, uint32_t max,
 /* Stack Management                                                           */
 /* -------------------------------------------------------------------------- */
 
-static bool try_place_stack(Player *player, uint8_t type, uint8_t count, int skip_slot) {
+static bool try_place_stack(Player *player, BlockId type, uint8_t count, int skip_slot) {
     if (count == 0) return true;
     
     for (int i = 0; i < INVENTORY_SIZE && count > 0; ++i) {
@@ -209,8 +209,8 @@ static bool try_place_stack(Player *player, uint8_t type, uint8_t count, int ski
 /* Slot Interaction (unified for inventory and crafting)                     */
 /* -------------------------------------------------------------------------- */
 
-static void handle_slot_click(uint8_t *slot_type, uint8_t *slot_count,
-                              uint8_t *held_type, uint8_t *held_count,
+static void handle_slot_click(BlockId *slot_type, uint8_t *slot_count,
+                              BlockId *held_type, uint8_t *held_count,
                               uint8_t *origin_slot, bool *origin_valid, bool *from_crafting,
                               int slot_index, bool is_crafting_grid) {
     if (*held_count == 0) {
@@ -242,7 +242,8 @@ static void handle_slot_click(uint8_t *slot_type, uint8_t *slot_count,
             *held_count = (uint8_t)(total - UINT8_MAX);
         }
     } else {
-        uint8_t temp_type = *slot_type, temp_count = *slot_count;
+        BlockId temp_type = *slot_type;
+        uint8_t temp_count = *slot_count;
         *slot_type = *held_type;
         *slot_count = *held_count;
         *held_type = temp_type;
@@ -250,8 +251,8 @@ static void handle_slot_click(uint8_t *slot_type, uint8_t *slot_count,
     }
 }
 
-static void handle_slot_right_click(uint8_t *slot_type, uint8_t *slot_count,
-                                    uint8_t *held_type, uint8_t *held_count,
+static void handle_slot_right_click(BlockId *slot_type, uint8_t *slot_count,
+                                    BlockId *held_type, uint8_t *held_count,
                                     uint8_t *origin_slot, bool *origin_valid, bool *from_crafting,
                                     int slot_index, bool is_crafting_grid) {
     if (*held_count != 0) {
@@ -428,7 +429,7 @@ void player_handle_block_interaction(Player *player, World *world, RayHit ray_hi
         uint8_t slot = player->selected_slot;
         if (slot >= INVENTORY_SIZE || player->inventory_counts[slot] == 0) return;
         
-        uint8_t place_type = player->inventory[slot];
+        BlockId place_type = player->inventory[slot];
         if (!item_is_placeable(place_type)) return;
         
         world_add_block(world, place, place_type);
@@ -452,7 +453,7 @@ RayHit raycast_blocks(World *world, Vec3 origin, Vec3 direction, float max_dista
         IVec3 cell = world_to_cell(point);
         
         if (!ivec3_equal(cell, previous_cell)) {
-            uint8_t type;
+            BlockId type;
             if (world_get_block_type(world, cell, &type)) {
                 result.hit = true;
                 result.cell = cell;
@@ -492,9 +493,9 @@ void resolve_collision_axis(World *world, Vec3 *position, float delta, int axis)
         for (int y = min_y; y <= max_y; ++y) {
             if (!world_y_in_bounds(y)) continue;
             for (int z = min_z; z <= max_z; ++z) {
-                uint8_t type;
+                BlockId type;
                 if (!world_get_block_type(world, (IVec3){x, y, z}, &type)) continue;
-                if (type == BLOCK_WATER) continue;
+                if (!block_is_solid(type)) continue;
                 
                 player_compute_aabb(*position, &player_box);
                 AABB block_box = cell_aabb((IVec3){x, y, z});
@@ -533,9 +534,9 @@ void resolve_collision_y(World *world, Vec3 *position, float *velocity_y, bool *
         for (int y = min_y; y <= max_y; ++y) {
             if (!world_y_in_bounds(y)) continue;
             for (int z = min_z; z <= max_z; ++z) {
-                uint8_t type;
+                BlockId type;
                 if (!world_get_block_type(world, (IVec3){x, y, z}, &type)) continue;
-                if (type == BLOCK_WATER) continue;
+                if (!block_is_solid(type)) continue;
                 
                 player_compute_aabb(*position, &player_box);
                 AABB block_box = cell_aabb((IVec3){x, y, z});
@@ -573,7 +574,7 @@ bool block_overlaps_player(const Player *player, IVec3 cell) {
 /* Inventory Management                                                       */
 /* -------------------------------------------------------------------------- */
 
-void player_inventory_add(Player *player, uint8_t type) {
+void player_inventory_add(Player *player, BlockId type) {
     for (int i = 0; i < INVENTORY_SIZE; ++i) {
         if (player->inventory_counts[i] > 0 && player->inventory[i] == type) {
             if (player->inventory_counts[i] < UINT8_MAX) {
@@ -639,7 +640,7 @@ void player_inventory_cancel_held(Player *player) {
     
     if (origin < 0 || origin >= INVENTORY_SIZE) return;
     
-    uint8_t held_type = player->inventory_held_type;
+    BlockId held_type = player->inventory_held_type;
     uint8_t held_count = player->inventory_held_count;
     
     if (player->inventory_counts[origin] == 0) {
@@ -658,7 +659,7 @@ void player_inventory_cancel_held(Player *player) {
             }
         }
     } else {
-        uint8_t displaced_type = player->inventory[origin];
+        BlockId displaced_type = player->inventory[origin];
         uint8_t displaced_count = player->inventory_counts[origin];
         if (!try_place_stack(player, displaced_type, displaced_count, origin)) {
             return;
@@ -795,7 +796,7 @@ void player_return_crafting_to_inventory(Player *player) {
     for (int slot = 0; slot < CRAFTING_SIZE; ++slot) {
         if (player->crafting_grid_counts[slot] == 0) continue;
         
-        uint8_t type = player->crafting_grid[slot];
+        BlockId type = player->crafting_grid[slot];
         uint8_t count = player->crafting_grid_counts[slot];
         
         for (int i = 0; i < INVENTORY_SIZE && count > 0; ++i) {
@@ -1105,7 +1106,7 @@ uint32_t player_inventory_icon_instances(const Player *player, float aspect,
             float center_x = layout.inv_left + layout.cell_w * (0.5f + col);
             float center_y = layout.inv_top - layout.cell_h * (0.5f + row);
             out_instances[icon_index] = (InstanceData){
-                center_x, center_y, 0.0f, (uint32_t)player->inventory[slot],
+                center_x, center_y, 0.0f, block_texture(player->inventory[slot]),
                 1.0f, 1.0f, 1.0f,
                 0.0f, 0.0f
             };
@@ -1124,7 +1125,7 @@ uint32_t player_inventory_icon_instances(const Player *player, float aspect,
             float center_x = layout.craft_left + craft_h_step * (0.5f + col);
             float center_y = layout.craft_top - craft_v_step * (0.5f + row);
             out_instances[icon_index] = (InstanceData){
-                center_x, center_y, 0.0f, (uint32_t)player->crafting_grid[slot],
+                center_x, center_y, 0.0f, block_texture(player->crafting_grid[slot]),
                 1.0f, 1.0f, 1.0f,
                 0.0f, 0.0f
             };
@@ -1139,7 +1140,7 @@ uint32_t player_inventory_icon_instances(const Player *player, float aspect,
                 float center_x = (layout.result_left + layout.result_right) * 0.5f;
                 float center_y = (layout.result_bottom + layout.result_top) * 0.5f;
                 out_instances[icon_index] = (InstanceData){
-                    center_x, center_y, 0.0f, (uint32_t)craft_result.result_type,
+                    center_x, center_y, 0.0f, block_texture(craft_result.result_type),
                     1.0f, 1.0f, 1.0f,
                     0.0f, 0.0f
                 };
@@ -1154,7 +1155,7 @@ uint32_t player_inventory_icon_instances(const Player *player, float aspect,
                 player->inventory_mouse_ndc_x,
                 player->inventory_mouse_ndc_y,
                 0.0f,
-                (uint32_t)player->inventory_held_type,
+                block_texture(player->inventory_held_type),
                 1.0f, 1.0f, 1.0f,
                 0.0f, 0.0f
             };
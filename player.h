@@ -33,13 +33,13 @@ typedef struct Player {
     uint8_t health;
     float fall_highest_y;
     
-    uint8_t inventory[INVENTORY_SIZE];
+    BlockId inventory[INVENTORY_SIZE];
     uint8_t inventory_counts[INVENTORY_SIZE];
     
-    uint8_t crafting_grid[CRAFTING_SIZE];
+    BlockId crafting_grid[CRAFTING_SIZE];
     uint8_t crafting_grid_counts[CRAFTING_SIZE];
     
-    uint8_t inventory_held_type;
+    BlockId inventory_held_type;
     uint8_t inventory_held_count;
     uint8_t inventory_held_origin_slot;
     bool inventory_held_origin_valid;
@@ -58,7 +58,7 @@ typedef struct {
     bool hit;
     IVec3 cell;
     IVec3 normal;
-    uint8_t type;
+    BlockId type;
 } RayHit;
 
 /* -------------------------------------------------------------------------- */
@@ -67,7 +67,7 @@ typedef struct {
 
 typedef struct {
     bool valid;
-    uint8_t result_type;
+    BlockId result_type;
     uint8_t result_count;
 } CraftingResult;
 
@@ -102,7 +102,7 @@ bool block_overlaps_player(const Player *player, IVec3 cell);
 /* Inventory Management                                                       */
 /* -------------------------------------------------------------------------- */
 
-void player_inventory_add(Player *player, uint8_t type);
+void player_inventory_add(Player *player, BlockId type);
 void player_inventory_handle_click(Player *player, int slot);
 void player_inventory_handle_right_click(Player *player, int slot);
 void player_inventory_cancel_held(Player *player);
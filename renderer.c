@@ -44,12 +44,27 @@ static const Vertex BLOCK_VERTICES[] = {
     {{-0.5f,  0.5f,  0.5f}, {0.0f, 1.0f}}, {{-0.5f, -0.5f,  0.5f}, {1.0f, 1.0f}},
 };
 
+/* Six indices per face, in FaceDirection order, so a single face draws with
+ * firstIndex = face * BLOCK_FACE_INDEX_COUNT */
+#define BLOCK_FACE_INDEX_COUNT 6u
+
 static const uint16_t BLOCK_INDICES[] = {
      0,  1,  2,  2,  3,  0,  6,  5,  4,  4,  7,  6,
      8, 11, 10, 10,  9,  8, 12, 13, 14, 14, 15, 12,
     16, 17, 18, 18, 19, 16, 22, 21, 20, 20, 23, 22
 };
 
+_Static_assert(sizeof(BLOCK_INDICES) / sizeof(BLOCK_INDICES[0]) == FACE_COUNT * BLOCK_FACE_INDEX_COUNT,
+               "Cube indices must hold one quad per face direction");
+
+/* Greedy chunk meshes are copied straight into the vertex buffer */
+_Static_assert(sizeof(MeshVertex) == sizeof(Vertex) &&
+               offsetof(MeshVertex, pos) == offsetof(Vertex, pos) &&
+               offsetof(MeshVertex, uv) == offsetof(Vertex, uv),
+               "MeshVertex must match Vertex");
+
+#define INITIAL_MESH_VERTEX_CAPACITY 65536u
+
 static const Vertex EDGE_VERTICES[] = {
     {{-0.5f, -0.5f,  0.5f}, {0.0f, 0.0f}}, {{ 0.5f, -0.5f,  0.5f}, {0.0f, 0.0f}},
     {{ 0.5f,  0.5f,  0.5f}, {0.0f, 0.0f}}, {{-0.5f,  0.5f,  0.5f}, {0.0f, 0.0f}},
@@ -95,6 +110,8 @@ struct Renderer {
     BufferObject instance_buf;
     BufferObject health_bar_bg, health_bar_border;
     uint32_t instance_capacity;
+    BufferObject mesh_vertex_buf, mesh_index_buf;
+    uint32_t mesh_vertex_capacity, mesh_index_capacity;
 
     VkDescriptorSetLayout descriptor_layout;
     VkPipelineLayout pipeline_layout;
@@ -1162,6 +1179,8 @@ void renderer_destroy(Renderer *r) {
     vkDestroyDescriptorSetLayout(r->device, r->descriptor_layout, NULL);
     
     destroy_buffer_object(r->device, &r->instance_buf);
+    destroy_buffer_object(r->device, &r->mesh_vertex_buf);
+    destroy_buffer_object(r->device, &r->mesh_index_buf);
     destroy_buffer_object(r->device, &r->health_bar_border);
     destroy_buffer_object(r->device, &r->health_bar_bg);
     destroy_buffer_object(r->device, &r->crafting_result);
@@ -1212,16 +1231,87 @@ static void ensure_instance_capacity(Renderer *r, uint32_t required) {
                               VK_BUFFER_USAGE_VERTEX_BUFFER_BIT);
 }
 
+/* Mesh buffers are created on first use; the instanced face path never needs them */
+static void ensure_mesh_capacity(Renderer *r, uint32_t vertex_count, uint32_t index_count) {
+    if (vertex_count > r->mesh_vertex_capacity) {
+        uint32_t new_cap = r->mesh_vertex_capacity > 0 ? r->mesh_vertex_capacity
+                                                       : INITIAL_MESH_VERTEX_CAPACITY;
+        while (new_cap < vertex_count) new_cap *= 2;
+        
+        vkDeviceWaitIdle(r->device);
+        destroy_buffer_object(r->device, &r->mesh_vertex_buf);
+        r->mesh_vertex_capacity = new_cap;
+        create_and_upload_buffer(r, &r->mesh_vertex_buf, NULL, new_cap * sizeof(Vertex),
+                                  VK_BUFFER_USAGE_VERTEX_BUFFER_BIT);
+    }
+    
+    if (index_count > r->mesh_index_capacity) {
+        uint32_t new_cap = r->mesh_index_capacity > 0 ? r->mesh_index_capacity
+                                                      : INITIAL_MESH_VERTEX_CAPACITY * 3 / 2;
+        while (new_cap < index_count) new_cap *= 2;
+        
+        vkDeviceWaitIdle(r->device);
+        destroy_buffer_object(r->device, &r->mesh_index_buf);
+        r->mesh_index_capacity = new_cap;
+        create_and_upload_buffer(r, &r->mesh_index_buf, NULL, new_cap * sizeof(uint32_t),
+                                  VK_BUFFER_USAGE_INDEX_BUFFER_BIT);
+    }
+}
+
+/* Concatenates chunk meshes; indices are rebased and laid out type by type so
+ * each block type draws as one range against its own instance */
+static void fill_mesh_buffers(Renderer *r, World *world, const WorldRenderTotals *totals) {
+    if (totals->mesh_index_total == 0) return;
+    
+    ensure_mesh_capacity(r, (uint32_t)totals->mesh_vertex_count, (uint32_t)totals->mesh_index_total);
+    
+    Vertex *vertices;
+    uint32_t *indices;
+    VK_CHECK(vkMapMemory(r->device, r->mesh_vertex_buf.memory, 0,
+                         (VkDeviceSize)totals->mesh_vertex_count * sizeof(Vertex), 0, (void **)&vertices));
+    VK_CHECK(vkMapMemory(r->device, r->mesh_index_buf.memory, 0,
+                         (VkDeviceSize)totals->mesh_index_total * sizeof(uint32_t), 0, (void **)&indices));
+    
+    uint32_t vertex_base = 0;
+    for (int i = 0; i < world->chunk_count; i++) {
+        Chunk *chunk = world->chunks[i];
+        memcpy(&vertices[vertex_base], chunk->mesh_vertices,
+               (size_t)chunk->mesh_vertex_count * sizeof(Vertex));
+        vertex_base += (uint32_t)chunk->mesh_vertex_count;
+    }
+    
+    uint32_t idx = 0;
+    for (int t = 0; t < ITEM_TYPE_COUNT; t++) {
+        if (totals->mesh_index_counts[t] == 0) continue;
+        
+        vertex_base = 0;
+        for (int i = 0; i < world->chunk_count; i++) {
+            Chunk *chunk = world->chunks[i];
+            int start = 0;
+            for (int d = 0; d < t; d++) start += chunk->mesh_index_counts[d];
+            
+            for (int j = start; j < start + chunk->mesh_index_counts[t]; j++) {
+                indices[idx++] = chunk->mesh_indices[j] + vertex_base;
+            }
+            vertex_base += (uint32_t)chunk->mesh_vertex_count;
+        }
+    }
+    
+    vkUnmapMemory(r->device, r->mesh_index_buf.memory);
+    vkUnmapMemory(r->device, r->mesh_vertex_buf.memory);
+}
+
 static uint32_t fill_instance_buffer(Renderer *r, World *world, const Player *player, float aspect,
-                                     int block_count, uint32_t entity_count,
+                                     int face_count, uint32_t entity_count,
                                      bool highlight, IVec3 highlight_cell,
+                                     uint32_t *out_mesh_types_start,
                                      uint32_t *out_highlight_idx, uint32_t *out_crosshair_idx,
                                      uint32_t *out_inventory_idx, uint32_t *out_selection_idx,
                                      uint32_t *out_bg_idx, uint32_t *out_health_bg_idx,
                                      uint32_t *out_health_border_idx,
                                      uint32_t *out_icons_start) {
     uint32_t icon_count = player_inventory_icon_instances(player, aspect, NULL, 0);
-    uint32_t total = (uint32_t)block_count + entity_count + 7 + icon_count;
+    uint32_t total = (uint32_t)face_count + entity_count + ITEM_TYPE_COUNT + 7 + icon_count;
     
     ensure_instance_capacity(r, total);
     
@@ -1230,15 +1320,21 @@ static uint32_t fill_instance_buffer(Renderer *r, World *world, const Player *pl
     
     uint32_t idx = 0;
     
-    for (int i = 0; i < world->chunk_count; i++) {
-        Chunk *chunk = world->chunks[i];
-        for (int j = 0; j < chunk->block_count; j++) {
-            Block b = chunk->blocks[j];
-            instances[idx++] = (InstanceData){
-                b.pos.x, b.pos.y, b.pos.z, b.type,
-                1.0f, 1.0f, 1.0f,
-                0.0f, 0.0f
-            };
+    /* World faces laid out direction by direction, one draw per direction */
+    for (int f = 0; f < FACE_COUNT; f++) {
+        for (int i = 0; i < world->chunk_count; i++) {
+            Chunk *chunk = world->chunks[i];
+            int start = 0;
+            for (int d = 0; d < f; d++) start += chunk->face_counts[d];
+            
+            for (int j = start; j < start + chunk->face_counts[f]; j++) {
+                Block b = chunk->blocks[j];
+                instances[idx++] = (InstanceData){
+                    b.pos.x, b.pos.y, b.pos.z, block_texture(b.type),
+                    1.0f, 1.0f, 1.0f,
+                    0.0f, 0.0f
+                };
+            }
         }
     }
 
@@ -1248,6 +1344,12 @@ static uint32_t fill_instance_buffer(Renderer *r, World *world, const Player *pl
                                                  total - idx);
     }
     
+    /* One untransformed instance per block texture for the greedy meshes */
+    *out_mesh_types_start = idx;
+    for (uint32_t t = 0; t < ITEM_TYPE_COUNT; t++) {
+        instances[idx++] = (InstanceData){0, 0, 0, t, 1.0f, 1.0f, 1.0f, 0.0f, 0.0f};
+    }
+    
     *out_highlight_idx = idx++;
     *out_crosshair_idx = idx++;
     *out_inventory_idx = idx++;
@@ -1317,12 +1419,15 @@ static void update_ui_buffers(Renderer *r, const Player *player, float aspect) {
 }
 
 static void record_world_rendering(VkCommandBuffer cmd, Renderer *r, uint32_t img_idx,
-                                    int world_instance_count, uint32_t highlight_idx, bool highlight,
+                                    const WorldRenderTotals *totals, uint32_t entity_count,
+                                    uint32_t mesh_types_start, uint32_t highlight_idx, bool highlight,
                                     const PushConstants *pc) {
     VkBuffer bufs[2];
     VkDeviceSize offsets[2] = {0, 0};
     
-    if (world_instance_count > 0) {
+    uint32_t face_total = (uint32_t)totals->face_total;
+    
+    if (face_total + entity_count > 0 || totals->mesh_index_total > 0) {
         vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, r->pipeline_solid);
         vkCmdPushConstants(cmd, r->pipeline_layout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(*pc), pc);
         
@@ -1333,8 +1438,37 @@ static void record_world_rendering(VkCommandBuffer cmd, Renderer *r, uint32_t im
         vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, r->pipeline_layout, 0, 1,
                                 &r->descriptor_sets_normal[img_idx], 0, NULL);
         
-        vkCmdDrawIndexed(cmd, (sizeof(BLOCK_INDICES) / sizeof((BLOCK_INDICES)[0])),
-                         world_instance_count, 0, 0, 0);
+        /* Terrain: only the quad of each instance's own face */
+        uint32_t first_instance = 0;
+        for (int f = 0; f < FACE_COUNT; f++) {
+            if (totals->face_counts[f] > 0) {
+                vkCmdDrawIndexed(cmd, BLOCK_FACE_INDEX_COUNT, (uint32_t)totals->face_counts[f],
+                                 (uint32_t)f * BLOCK_FACE_INDEX_COUNT, 0, first_instance);
+            }
+            first_instance += (uint32_t)totals->face_counts[f];
+        }
+        
+        /* Entities: whole cubes */
+        if (entity_count > 0) {
+            vkCmdDrawIndexed(cmd, (sizeof(BLOCK_INDICES) / sizeof((BLOCK_INDICES)[0])),
+                             entity_count, 0, 0, face_total);
+        }
+        
+        /* Greedy terrain: world-space quads, one range and instance per block type */
+        if (totals->mesh_index_total > 0) {
+            bufs[0] = r->mesh_vertex_buf.buffer;
+            vkCmdBindVertexBuffers(cmd, 0, 2, bufs, offsets);
+            vkCmdBindIndexBuffer(cmd, r->mesh_index_buf.buffer, 0, VK_INDEX_TYPE_UINT32);
+            
+            uint32_t first_index = 0;
+            for (uint32_t t = 0; t < ITEM_TYPE_COUNT; t++) {
+                uint32_t count = (uint32_t)totals->mesh_index_counts[t];
+                if (count > 0) {
+                    vkCmdDrawIndexed(cmd, count, 1, first_index, 0, mesh_types_start + t);
+                }
+                first_index += count;
+            }
+        }
     }
     
     if (highlight) {
@@ -1515,13 +1649,15 @@ void renderer_draw_frame(Renderer *r, World *world, const Player *player, Camera
     
     uint32_t highlight_idx, crosshair_idx, inventory_idx, selection_idx, bg_idx;
     uint32_t health_bg_idx, health_border_idx, icons_start;
-    int block_count = world_total_render_blocks(world);
+    uint32_t mesh_types_start;
+    WorldRenderTotals totals;
+    world_prepare_render(world, &totals);
     uint32_t entity_count = world_get_entity_render_block_count(world);
-    int world_instance_count = block_count + (int)entity_count;
+    fill_mesh_buffers(r, world, &totals);
     uint32_t icon_count = fill_instance_buffer(r, world, player, aspect,
-                                                block_count, entity_count,
+                                                totals.face_total, entity_count,
                                                 highlight, highlight_cell,
-                                                &highlight_idx, &crosshair_idx, &inventory_idx,
+                                                &mesh_types_start, &highlight_idx, &crosshair_idx, &inventory_idx,
                                                 &selection_idx, &bg_idx,
                                                 &health_bg_idx, &health_border_idx, &icons_start);
     
@@ -1529,7 +1665,7 @@ void renderer_draw_frame(Renderer *r, World *world, const Player *player, Camera
     
     PushConstants pc = {
         .view = camera_view_matrix(camera),
-        .proj = mat4_perspective(55.0f * M_PI / 180.0f,
+        .proj = mat4_perspective(camera->fov * (float)M_PI / 180.0f,
                                  (float)r->extent.width / (float)r->extent.height, 0.1f, 200.0f)
     };
     
@@ -1558,7 +1694,8 @@ void renderer_draw_frame(Renderer *r, World *world, const Player *player, Camera
     
     vkCmdBeginRenderPass(cmd, &rp_begin, VK_SUBPASS_CONTENTS_INLINE);
     
-    record_world_rendering(cmd, r, img_idx, world_instance_count, highlight_idx, highlight, &pc);
+    record_world_rendering(cmd, r, img_idx, &totals, entity_count, mesh_types_start,
+                           highlight_idx, highlight, &pc);
     
     if (!player->inventory_open) {
         record_crosshair_rendering(cmd, r, img_idx, player, crosshair_idx,
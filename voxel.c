@@ -7,6 +7,7 @@
 #include <time.h>
 
 #include "math.h"
+#include "arena.h"
 #include "io.h"
 #include "camera.h"
 #include "world.h"
@@ -182,6 +183,7 @@ static void process_events(IOContext *io, Renderer *renderer, Player *player, Mo
                 *window_width = event.data.resize.width;
                 *window_height = event.data.resize.height;
                 renderer_resize(renderer, *window_width, *window_height);
+                camera_set_aspect(camera, *window_width, *window_height);
                 if (ms->captured) {
                     ms->first_mouse = true;
                 }
@@ -243,12 +245,12 @@ int main(void) {
     Renderer *renderer = renderer_create(display, window, window_width, window_height);
     
     WorldSave save;
-    world_save_init(&save, WORLD_SAVE_FILE);
+    world_save_init(&save, WORLD_SAVE_DIR);
     world_save_load(&save);
     
     World world;
     world_init(&world, &save);
-    world_update_chunks(&world, world.spawn_position);
+    world_update_chunks(&world, world.spawn_position, NULL);
     if (!world.spawn_set) {
         world.spawn_position = vec3(0.0f, 4.5f, 0.0f);
     }
@@ -267,9 +269,10 @@ int main(void) {
     
     Camera camera;
     camera_init(&camera);
+    camera_set_aspect(&camera, window_width, window_height);
     camera_follow_player(&camera, &player);
     
-    world_update_chunks(&world, player.position);
+    world_update_chunks(&world, player.position, &camera);
     
     bool keys[256] = {0};
     MouseState mouse_state;
@@ -280,7 +283,7 @@ int main(void) {
     
     bool running = true;
     while (running) {
-        world_update_chunks(&world, player.position);
+        world_update_chunks(&world, player.position, &camera);
         
         bool left_click, right_click;
         process_events(io, renderer, &player, &mouse_state, keys,
@@ -310,6 +313,7 @@ int main(void) {
                                        left_click, right_click, interaction_enabled);
         
         if (time_state_should_autosave(&time_state)) {
+            world_save_edited_chunks(&world);
             world_save_store_player(&save, &player);
             world_save_flush(&save);
         }
@@ -324,5 +328,12 @@ int main(void) {
     renderer_destroy(renderer);
     io_destroy(io);
     
+#if ARENA_REPORT_STATS
+    ArenaStats arena_stats;
+    arena_get_stats(&arena_stats);
+    printf("Chunk arena: %zu KB peak in use, %zu KB reserved in %zu mappings\n",
+           arena_stats.peak_in_use / 1024, arena_stats.reserved / 1024, arena_stats.system_allocs);
+#endif
+    
     return 0;
 }
\ No newline at end of file
@@ -1,10 +1,18 @@
 #include "world.h"
+#include "arena.h"
 #include "player.h"
 #include "entity.h"
+#include "camera.h"
 #include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <zlib.h>
 
 static void die(const char *message) {
     fprintf(stderr, "Error: %s\n", message);
@@ -29,12 +37,8 @@ static inline int chunk_to_base(int chunk_coord) {
     return chunk_coord * CHUNK_SIZE;
 }
 
-static inline size_t voxel_index(int x, int y, int z) {
-    return ((size_t)y * CHUNK_SIZE + (size_t)z) * CHUNK_SIZE + (size_t)x;
-}
-
-static inline size_t chunk_voxel_count(void) {
-    return CHUNK_SIZE * CHUNK_HEIGHT * CHUNK_SIZE;
+static inline size_t section_voxel_index(int x, int sy, int z) {
+    return ((size_t)sy * CHUNK_SIZE + (size_t)z) * CHUNK_SIZE + (size_t)x;
 }
 
 IVec3 world_to_cell(Vec3 p) {
@@ -60,434 +64,2364 @@ AABB cell_aabb(IVec3 cell) {
     };
 }
 
-static inline bool is_air(uint8_t type) {
-    return type == 255;
+#define BLOCK_TERRAIN (BLOCK_FLAG_SOLID | BLOCK_FLAG_OPAQUE | BLOCK_FLAG_PLACEABLE)
+
+const BlockInfo BLOCK_REGISTRY[BLOCK_ID_COUNT] = {
+    [BLOCK_DIRT] = {BLOCK_TERRAIN, BLOCK_DIRT},
+    [BLOCK_STONE] = {BLOCK_TERRAIN, BLOCK_STONE},
+    [BLOCK_GRASS] = {BLOCK_TERRAIN, BLOCK_GRASS},
+    [BLOCK_SAND] = {BLOCK_TERRAIN, BLOCK_SAND},
+    [BLOCK_WATER] = {BLOCK_FLAG_LIQUID | BLOCK_FLAG_PLACEABLE, BLOCK_WATER},
+    [BLOCK_WOOD] = {BLOCK_TERRAIN, BLOCK_WOOD},
+    [BLOCK_LEAVES] = {BLOCK_TERRAIN, BLOCK_LEAVES},
+    [BLOCK_PLANKS] = {BLOCK_TERRAIN, BLOCK_PLANKS},
+    [ITEM_STICK] = {0, ITEM_STICK},
+    [BLOCK_AIR] = {0, 0},
+};
+
+static inline bool is_air(BlockId type) {
+    return type == BLOCK_AIR;
+}
+
+/* Faces between two blocks of one class are hidden: air, opaque or liquid */
+static inline unsigned block_face_class(BlockId type) {
+    return BLOCK_REGISTRY[type].flags & (BLOCK_FLAG_OPAQUE | BLOCK_FLAG_LIQUID);
 }
 
-static inline bool is_water(uint8_t type) {
-    return type == BLOCK_WATER;
+static inline bool block_id_valid(BlockId type) {
+    return type < BLOCK_ID_COUNT;
 }
 
-bool item_is_placeable(uint8_t type) {
-    return type < ITEM_STICK;
+bool item_is_placeable(BlockId type) {
+    return block_has_flag(type, BLOCK_FLAG_PLACEABLE);
 }
 
 /* -------------------------------------------------------------------------- */
-/* World Save                                                                 */
+/* Chunk Sections                                                             */
 /* -------------------------------------------------------------------------- */
 
-static int save_find_chunk(const WorldSave *save, int cx, int cz) {
-    for (int i = 0; i < save->count; ++i) {
-        if (save->records[i].cx == cx && save->records[i].cz == cz) {
-            return i;
+/* Sections pack one palette index per voxel at 1, 2 or 4 bits, or store raw
+ * BlockIds at 16 bits once more than CHUNK_SECTION_PALETTE_MAX types mix.
+ * Packed widths divide 8, so an index never straddles a byte. */
+#define SECTION_RAW_BITS 16
+
+static inline size_t section_data_size(int bits) {
+    return (size_t)CHUNK_SECTION_VOXELS * (size_t)bits / 8u;
+}
+
+static inline BlockId *section_raw(const ChunkSection *section) {
+    return (BlockId *)(void *)section->data;
+}
+
+static inline unsigned section_read(const ChunkSection *section, size_t i) {
+    size_t bit = i * section->bits;
+    return (section->data[bit >> 3] >> (bit & 7u)) & ((1u << section->bits) - 1u);
+}
+
+static inline void section_write(ChunkSection *section, size_t i, unsigned value) {
+    size_t bit = i * section->bits;
+    unsigned shift = (unsigned)(bit & 7u);
+    unsigned mask = ((1u << section->bits) - 1u) << shift;
+    uint8_t *byte = &section->data[bit >> 3];
+    *byte = (uint8_t)((*byte & ~mask) | ((value << shift) & mask));
+}
+
+static inline BlockId section_get(const ChunkSection *section, size_t i) {
+    if (section->bits == 0) return section->palette[0];
+    if (section->bits == SECTION_RAW_BITS) return section_raw(section)[i];
+    return section->palette[section_read(section, i)];
+}
+
+static inline void decode_packed_row(const uint8_t *in, const BlockId *palette, unsigned bits,
+                                     BlockId out[CHUNK_SIZE]) {
+    unsigned mask = (1u << bits) - 1u;
+    for (int x = 0; x < CHUNK_SIZE; ++in) {
+        for (unsigned byte = *in, k = 0; k < 8u; k += bits) {
+            out[x++] = palette[(byte >> k) & mask];
         }
     }
-    return -1;
 }
 
-static void save_ensure_capacity(WorldSave *save, int min_capacity) {
-    if (save->capacity >= min_capacity) return;
-    
-    int new_cap = save->capacity > 0 ? save->capacity : 64;
-    while (new_cap < min_capacity) new_cap *= 2;
-    
-    ChunkRecord *new_records = realloc(save->records, (size_t)new_cap * sizeof(ChunkRecord));
-    if (!new_records) die("Failed to grow world save");
+/* Voxels of one row along x starting at index `start`; rows start on a byte */
+static void section_decode_row(const ChunkSection *section, size_t start, BlockId out[CHUNK_SIZE]) {
+    const uint8_t *in = &section->data[start * section->bits / 8u];
     
-    save->records = new_records;
-    save->capacity = new_cap;
+    /* Constant widths let each loop unroll */
+    switch (section->bits) {
+    case 0: for (int x = 0; x < CHUNK_SIZE; ++x) out[x] = section->palette[0]; break;
+    case 1: decode_packed_row(in, section->palette, 1, out); break;
+    case 2: decode_packed_row(in, section->palette, 2, out); break;
+    case 4: decode_packed_row(in, section->palette, 4, out); break;
+    default: memcpy(out, in, CHUNK_SIZE * sizeof(BlockId)); break;
+    }
 }
 
-void world_save_init(WorldSave *save, const char *path) {
-    memset(save, 0, sizeof(*save));
-    snprintf(save->path, sizeof(save->path), "%s", path);
+static void section_set_uniform(ChunkSection *section, BlockId type) {
+    arena_free(section->data, section_data_size(section->bits));
+    *section = (ChunkSection){.data = NULL, .bits = 0, .palette_count = 1, .palette = {type}};
 }
 
-bool world_save_load(WorldSave *save) {
-    FILE *f = fopen(save->path, "rb");
-    if (!f) return false;
+static void sections_free(ChunkSection *sections) {
+    for (int i = 0; i < CHUNK_SECTION_COUNT; ++i) {
+        arena_free(sections[i].data, section_data_size(sections[i].bits));
+        sections[i].data = NULL;
+    }
+}
+
+static inline unsigned palette_find(const BlockId *palette, int count, BlockId type) {
+    int p = 0;
+    while (p < count && palette[p] != type) ++p;
+    return p < count ? (unsigned)p : 0u;
+}
+
+/* Re-encodes every voxel at `bits` per voxel against `palette`, which must
+ * hold every type present; raw sections ignore it */
+static void section_repack(ChunkSection *section, int bits, const BlockId *palette, int palette_count) {
+    ChunkSection packed = {.bits = (uint8_t)bits};
+    if (bits != SECTION_RAW_BITS) {
+        packed.palette_count = (uint8_t)palette_count;
+        memcpy(packed.palette, palette, (size_t)palette_count * sizeof(BlockId));
+    }
     
-    uint32_t magic, version, file_chunk_size, record_count;
-    int32_t file_min_y, file_max_y;
+    size_t size = section_data_size(bits);
+    packed.data = arena_alloc(size);
+    if (!packed.data) die("Failed to allocate chunk section");
     
-    if (fread(&magic, sizeof(magic), 1, f) != 1 ||
-        fread(&version, sizeof(version), 1, f) != 1 ||
-        fread(&file_chunk_size, sizeof(file_chunk_size), 1, f) != 1 ||
-        fread(&file_min_y, sizeof(file_min_y), 1, f) != 1 ||
-        fread(&file_max_y, sizeof(file_max_y), 1, f) != 1 ||
-        fread(&record_count, sizeof(record_count), 1, f) != 1) {
-        fclose(f);
-        return false;
+    if (section->bits == SECTION_RAW_BITS) {
+        /* Only compaction narrows a raw section, to a palette of at most 16 types */
+        const BlockId *raw = section_raw(section);
+        for (size_t i = 0; i < CHUNK_SECTION_VOXELS; ++i) {
+            section_write(&packed, i, palette_find(palette, palette_count, raw[i]));
+        }
+        arena_free(section->data, section_data_size(SECTION_RAW_BITS));
+        *section = packed;
+        return;
     }
     
-    if (magic != WORLD_SAVE_MAGIC ||
-        version != WORLD_SAVE_VERSION ||
-        file_chunk_size != CHUNK_SIZE ||
-        file_min_y != WORLD_MIN_Y ||
-        file_max_y != WORLD_MAX_Y) {
-        fclose(f);
-        return false;
+    /* New stored value for each old one, so voxels never go through their type */
+    BlockId translate[CHUNK_SECTION_PALETTE_MAX] = {0};
+    for (int v = 0; v < section->palette_count; ++v) {
+        BlockId type = section->palette[v];
+        translate[v] = bits == SECTION_RAW_BITS ? type : (BlockId)palette_find(palette, palette_count, type);
     }
-
-    /* Load player data */
-    save->has_player_data = false;
-    if (fread(&save->player_position.x, sizeof(float), 1, f) == 1 &&
-        fread(&save->player_position.y, sizeof(float), 1, f) == 1 &&
-        fread(&save->player_position.z, sizeof(float), 1, f) == 1 &&
-        fread(&save->player_health, sizeof(uint8_t), 1, f) == 1 &&
-        fread(&save->player_selected_slot, sizeof(uint8_t), 1, f) == 1 &&
-        fread(save->player_inventory, sizeof(uint8_t), 27, f) == 27 &&
-        fread(save->player_inventory_counts, sizeof(uint8_t), 27, f) == 27) {
-        save->has_player_data = true;
+    
+    unsigned old_bits = section->bits;
+    unsigned old_mask = (1u << old_bits) - 1u;
+    size_t old_size = section_data_size(section->bits);
+    if (bits == SECTION_RAW_BITS) {
+        BlockId *out = section_raw(&packed);
+        if (old_bits == 0) {
+            for (size_t i = 0; i < CHUNK_SECTION_VOXELS; ++i) out[i] = translate[0];
+        } else {
+            for (size_t b = 0; b < old_size; ++b) {
+                for (unsigned byte = section->data[b], k = 0; k < 8u; k += old_bits) {
+                    *out++ = translate[(byte >> k) & old_mask];
+                }
+            }
+        }
+    } else if (old_bits == 0) {
+        /* Every voxel is old value 0: one repeated byte */
+        unsigned pattern = 0;
+        for (unsigned k = 0; k < 8u; k += (unsigned)bits) pattern |= (unsigned)translate[0] << k;
+        memset(packed.data, (int)pattern, size);
     } else {
-        fclose(f);
-        return false;
+        /* Unpack each old byte and repack its values at the new width */
+        uint8_t *out = packed.data;
+        unsigned acc = 0, shift = 0;
+        for (size_t b = 0; b < old_size; ++b) {
+            for (unsigned byte = section->data[b], k = 0; k < 8u; k += old_bits) {
+                acc |= (unsigned)translate[(byte >> k) & old_mask] << shift;
+                shift += (unsigned)bits;
+                if (shift == 8u) {
+                    *out++ = (uint8_t)acc;
+                    acc = 0;
+                    shift = 0;
+                }
+            }
+        }
     }
     
-    /* Free existing records */
-    for (int i = 0; i < save->count; ++i) {
-        free(save->records[i].voxels);
+    arena_free(section->data, old_size);
+    *section = packed;
+}
+
+static void section_set(ChunkSection *section, size_t i, BlockId type) {
+    if (section->bits == SECTION_RAW_BITS) {
+        section_raw(section)[i] = type;
+        return;
     }
-    free(save->records);
-    save->records = NULL;
-    save->count = 0;
-    save->capacity = 0;
     
-    if (record_count == 0) {
-        fclose(f);
-        save->dirty = false;
-        return true;
+    int index = 0;
+    while (index < section->palette_count && section->palette[index] != type) ++index;
+    
+    if (index == section->palette_count) {
+        if (section->palette_count < (1 << section->bits)) {
+            section->palette[section->palette_count++] = type;
+        } else {
+            /* Palette full: double the index width (0 -> 1 -> 2 -> 4), then go raw */
+            int bits = section->bits == 0 ? 1 : section->bits < 4 ? section->bits * 2 : SECTION_RAW_BITS;
+            if (bits == SECTION_RAW_BITS) {
+                section_repack(section, bits, NULL, 0);
+                section_raw(section)[i] = type;
+                return;
+            }
+            
+            BlockId palette[CHUNK_SECTION_PALETTE_MAX];
+            memcpy(palette, section->palette, (size_t)section->palette_count * sizeof(BlockId));
+            palette[index] = type;
+            section_repack(section, bits, palette, index + 1);
+        }
     }
     
-    save->records = calloc(record_count, sizeof(ChunkRecord));
-    if (!save->records) die("Failed to allocate save records");
-    save->capacity = (int)record_count;
+    /* A uniform section already holds its only palette type everywhere */
+    if (section->bits) section_write(section, i, (unsigned)index);
+}
+
+/* Rebuilds the palette from the types still present and repacks at the
+ * narrowest width; a section left with one type becomes uniform again */
+static void section_compact(ChunkSection *section) {
+    if (section->bits == 0) return;
     
-    size_t voxel_size = chunk_voxel_count();
-    for (uint32_t i = 0; i < record_count; ++i) {
-        int32_t cx, cz;
-        if (fread(&cx, sizeof(cx), 1, f) != 1 ||
-            fread(&cz, sizeof(cz), 1, f) != 1) {
-            fclose(f);
-            return false;
+    BlockId palette[CHUNK_SECTION_PALETTE_MAX];
+    int count = 0;
+    if (section->bits == SECTION_RAW_BITS) {
+        /* Distinct types, giving up once they no longer fit a palette */
+        const BlockId *raw = section_raw(section);
+        for (size_t i = 0; i < CHUNK_SECTION_VOXELS && count <= CHUNK_SECTION_PALETTE_MAX; ++i) {
+            int p = 0;
+            while (p < count && palette[p] != raw[i]) ++p;
+            if (p < count) continue;
+            if (count < CHUNK_SECTION_PALETTE_MAX) palette[count] = raw[i];
+            count++;
         }
-        
-        uint8_t *voxels = malloc(voxel_size);
-        if (!voxels || fread(voxels, 1, voxel_size, f) != voxel_size) {
-            free(voxels);
-            fclose(f);
-            return false;
+    } else {
+        /* Mark the palette indices still in use */
+        bool used[CHUNK_SECTION_PALETTE_MAX] = {false};
+        unsigned mask = (1u << section->bits) - 1u;
+        size_t size = section_data_size(section->bits);
+        for (size_t b = 0; b < size; ++b) {
+            for (unsigned byte = section->data[b], k = 0; k < 8u; k += section->bits) {
+                used[(byte >> k) & mask] = true;
+            }
+        }
+        for (int v = 0; v < section->palette_count; ++v) {
+            if (used[v]) palette[count++] = section->palette[v];
         }
-        
-        save->records[i] = (ChunkRecord){.cx = cx, .cz = cz, .voxels = voxels};
-        save->count++;
     }
     
-    fclose(f);
-    save->dirty = false;
-    return true;
+    if (count == 1) {
+        section_set_uniform(section, palette[0]);
+        return;
+    }
+    
+    int bits = count <= 2 ? 1 : count <= 4 ? 2 : count <= CHUNK_SECTION_PALETTE_MAX ? 4 : SECTION_RAW_BITS;
+    bool stale = bits != SECTION_RAW_BITS && count != section->palette_count;
+    if (bits != section->bits || stale) section_repack(section, bits, palette, count);
 }
 
-void world_save_flush(WorldSave *save) {
-    if (!save->dirty) return;
-    
-    char tmp_path[300];
-    snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", save->path);
+/* Replaces the section with CHUNK_SECTION_VOXELS dense voxels in (y, z, x)
+ * order, encoded at the narrowest width in one pass */
+static void section_encode(ChunkSection *section, const BlockId *voxels) {
+    BlockId palette[CHUNK_SECTION_PALETTE_MAX];
+    uint8_t index_of[BLOCK_ID_COUNT];
+    memset(index_of, 0xFF, sizeof(index_of));
     
-    FILE *f = fopen(tmp_path, "wb");
-    if (!f) die("Failed to open temp save file");
-    
-    uint32_t magic = WORLD_SAVE_MAGIC;
-    uint32_t version = WORLD_SAVE_VERSION;
-    uint32_t file_chunk_size = CHUNK_SIZE;
-    int32_t file_min_y = WORLD_MIN_Y;
-    int32_t file_max_y = WORLD_MAX_Y;
-    uint32_t record_count = (uint32_t)save->count;
-    
-    if (fwrite(&magic, sizeof(magic), 1, f) != 1 ||
-        fwrite(&version, sizeof(version), 1, f) != 1 ||
-        fwrite(&file_chunk_size, sizeof(file_chunk_size), 1, f) != 1 ||
-        fwrite(&file_min_y, sizeof(file_min_y), 1, f) != 1 ||
-        fwrite(&file_max_y, sizeof(file_max_y), 1, f) != 1 ||
-        fwrite(&record_count, sizeof(record_count), 1, f) != 1) {
-        fclose(f);
-        remove(tmp_path);
-        die("Failed to write save header");
+    /* Distinct types in first-seen order, giving up once they no longer fit */
+    int count = 0;
+    BlockId prev = voxels[0];
+    index_of[prev] = 0;
+    palette[count++] = prev;
+    for (size_t i = 1; i < CHUNK_SECTION_VOXELS && count <= CHUNK_SECTION_PALETTE_MAX; ++i) {
+        BlockId type = voxels[i];
+        if (type == prev || index_of[type] != 0xFF) {
+            prev = type;
+            continue;
+        }
+        if (count < CHUNK_SECTION_PALETTE_MAX) {
+            index_of[type] = (uint8_t)count;
+            palette[count] = type;
+        }
+        count++;
+        prev = type;
     }
-
-    /* Write player data */
-    if (fwrite(&save->player_position.x, sizeof(float), 1, f) != 1 ||
-        fwrite(&save->player_position.y, sizeof(float), 1, f) != 1 ||
-        fwrite(&save->player_position.z, sizeof(float), 1, f) != 1 ||
-        fwrite(&save->player_health, sizeof(uint8_t), 1, f) != 1 ||
-        fwrite(&save->player_selected_slot, sizeof(uint8_t), 1, f) != 1 ||
-        fwrite(save->player_inventory, sizeof(uint8_t), 27, f) != 27 ||
-        fwrite(save->player_inventory_counts, sizeof(uint8_t), 27, f) != 27) {
-        fclose(f);
-        remove(tmp_path);
-        die("Failed to write player data");
+    
+    if (count == 1) {
+        section_set_uniform(section, palette[0]);
+        return;
     }
     
-    size_t voxel_size = chunk_voxel_count();
-    for (int i = 0; i < save->count; ++i) {
-        int32_t cx = save->records[i].cx;
-        int32_t cz = save->records[i].cz;
+    int bits = count <= 2 ? 1 : count <= 4 ? 2 : count <= CHUNK_SECTION_PALETTE_MAX ? 4 : SECTION_RAW_BITS;
+    ChunkSection encoded = {.bits = (uint8_t)bits};
+    size_t size = section_data_size(bits);
+    encoded.data = arena_alloc(size);
+    if (!encoded.data) die("Failed to allocate chunk section");
+    
+    if (bits == SECTION_RAW_BITS) {
+        memcpy(encoded.data, voxels, size);
+    } else {
+        encoded.palette_count = (uint8_t)count;
+        memcpy(encoded.palette, palette, (size_t)count * sizeof(BlockId));
         
-        if (fwrite(&cx, sizeof(cx), 1, f) != 1 ||
-            fwrite(&cz, sizeof(cz), 1, f) != 1 ||
-            fwrite(save->records[i].voxels, 1, voxel_size, f) != voxel_size) {
-            fclose(f);
-            remove(tmp_path);
-            die("Failed to write save record");
+        /* Whole output bytes at a time; packed widths divide 8 */
+        unsigned per_byte = 8u / (unsigned)bits;
+        for (size_t b = 0; b < size; ++b) {
+            const BlockId *in = &voxels[b * per_byte];
+            unsigned byte = 0;
+            for (unsigned k = 0; k < per_byte; ++k) byte |= (unsigned)index_of[in[k]] << (k * (unsigned)bits);
+            encoded.data[b] = (uint8_t)byte;
         }
     }
     
-    fclose(f);
+    section_set_uniform(section, BLOCK_AIR);
+    *section = encoded;
+}
+
+/* -------------------------------------------------------------------------- */
+/* Chunk Edits                                                                */
+/* -------------------------------------------------------------------------- */
+
+static inline uint32_t chunk_voxel_index(int lx, int ly, int lz) {
+    return ((uint32_t)ly * CHUNK_SIZE + (uint32_t)lz) * CHUNK_SIZE + (uint32_t)lx;
+}
+
+static void chunk_reserve_edits(Chunk *chunk, int min_capacity) {
+    if (chunk->edit_capacity >= min_capacity) return;
     
-    if (rename(tmp_path, save->path) != 0) {
-        remove(tmp_path);
-        die("Failed to replace save file");
-    }
+    int new_cap = chunk->edit_capacity > 0 ? chunk->edit_capacity : 16;
+    while (new_cap < min_capacity) new_cap *= 2;
+    
+    ChunkEdit *new_edits = arena_realloc(chunk->edits, (size_t)chunk->edit_capacity * sizeof(ChunkEdit),
+                                         (size_t)new_cap * sizeof(ChunkEdit));
+    if (!new_edits) die("Failed to allocate chunk edits");
     
-    save->dirty = false;
+    chunk->edits = new_edits;
+    chunk->edit_capacity = new_cap;
 }
 
-void world_save_destroy(WorldSave *save) {
-    world_save_flush(save);
-    for (int i = 0; i < save->count; ++i) {
-        free(save->records[i].voxels);
+/* First edit at or past `voxel` */
+static int edits_lower_bound(const ChunkEdit *edits, int count, uint32_t voxel) {
+    int lo = 0, hi = count;
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        if (edits[mid].voxel < voxel) lo = mid + 1;
+        else hi = mid;
     }
-    free(save->records);
-    memset(save, 0, sizeof(*save));
+    return lo;
 }
 
-static void save_store_chunk(WorldSave *save, int cx, int cz, const uint8_t *voxels) {
-    int idx = save_find_chunk(save, cx, cz);
-    size_t voxel_size = chunk_voxel_count();
-    
-    if (idx < 0) {
-        save_ensure_capacity(save, save->count + 1);
-        idx = save->count++;
-        save->records[idx].cx = cx;
-        save->records[idx].cz = cz;
-        save->records[idx].voxels = malloc(voxel_size);
-        if (!save->records[idx].voxels) die("Failed to allocate save voxels");
+/* -------------------------------------------------------------------------- */
+/* World Save                                                                 */
+/* -------------------------------------------------------------------------- */
+
+static int records_find(const ChunkRecord *records, int count, int cx, int cz) {
+    for (int i = 0; i < count; ++i) {
+        if (records[i].cx == cx && records[i].cz == cz) {
+            return i;
+        }
     }
-    
-    memcpy(save->records[idx].voxels, voxels, voxel_size);
-    save->dirty = true;
+    return -1;
 }
 
-static bool save_load_chunk(const WorldSave *save, int cx, int cz, uint8_t *out_voxels) {
-    int idx = save_find_chunk(save, cx, cz);
-    if (idx < 0) return false;
+static void save_ensure_capacity(WorldSave *save, int min_capacity) {
+    if (save->capacity >= min_capacity) return;
     
-    memcpy(out_voxels, save->records[idx].voxels, chunk_voxel_count());
-    return true;
+    int new_cap = save->capacity > 0 ? save->capacity : 64;
+    while (new_cap < min_capacity) new_cap *= 2;
+    
+    ChunkRecord *new_records = realloc(save->records, (size_t)new_cap * sizeof(ChunkRecord));
+    if (!new_records) die("Failed to grow world save");
+    
+    save->records = new_records;
+    save->capacity = new_cap;
 }
 
-void world_save_store_player(WorldSave *save, const Player *player) {
-    if (!save || !player) return;
+static void records_clear(ChunkRecord *records, int *count) {
+    for (int i = 0; i < *count; ++i) {
+        free(records[i].edits);
+    }
+    *count = 0;
+}
 
-    save->player_position = player->position;
-    save->player_health = player->health;
-    save->player_selected_slot = player->selected_slot;
+/* -------------------------------------------------------------------------- */
+/* Chunk Record Encoding                                                      */
+/* -------------------------------------------------------------------------- */
 
-    for (int i = 0; i < 27; ++i) {
-        save->player_inventory[i] = player->inventory[i];
-        save->player_inventory_counts[i] = player->inventory_counts[i];
-    }
+typedef struct {
+    uint8_t *data;
+    size_t size;
+    size_t capacity;
+} SaveBuffer;
 
-    save->has_player_data = true;
-    save->dirty = true;
+/* Room for `size` more bytes past the end */
+static void save_buffer_reserve(SaveBuffer *buffer, size_t size) {
+    if (buffer->size + size <= buffer->capacity) return;
+    
+    size_t new_cap = buffer->capacity > 0 ? buffer->capacity : 4096;
+    while (new_cap < buffer->size + size) new_cap *= 2;
+    
+    uint8_t *new_data = realloc(buffer->data, new_cap);
+    if (!new_data) die("Failed to allocate save buffer");
+    buffer->data = new_data;
+    buffer->capacity = new_cap;
 }
 
-bool world_save_load_player(const WorldSave *save, Player *player) {
-    if (!save || !player || !save->has_player_data) return false;
+static void save_buffer_append(SaveBuffer *buffer, const void *src, size_t size) {
+    save_buffer_reserve(buffer, size);
+    memcpy(buffer->data + buffer->size, src, size);
+    buffer->size += size;
+}
 
-    player->position = save->player_position;
-    player->health = save->player_health;
-    player->selected_slot = save->player_selected_slot;
+typedef struct {
+    const uint8_t *data;
+    size_t size;
+    size_t pos;
+} SaveReader;
 
-    for (int i = 0; i < 27; ++i) {
-        player->inventory[i] = save->player_inventory[i];
-        player->inventory_counts[i] = save->player_inventory_counts[i];
+static bool save_read(SaveReader *reader, void *dst, size_t size) {
+    if (reader->size - reader->pos < size) return false;
+    memcpy(dst, reader->data + reader->pos, size);
+    reader->pos += size;
+    return true;
+}
+
+/* Largest record: every voxel edited */
+#define REGION_MAX_RECORD \
+    (sizeof(uint32_t) + CHUNK_VOXELS * (sizeof(uint32_t) + sizeof(BlockId)))
+
+/* A record is the edit count, the gaps between successive voxel indices,
+ * then the blocks; edits cluster and repeat blocks, so both columns
+ * compress to runs */
+static void save_encode_edits(const ChunkEdit *edits, int count, SaveBuffer *buffer) {
+    uint32_t stored = (uint32_t)count;
+    save_buffer_append(buffer, &stored, sizeof(stored));
+    
+    uint32_t previous = 0;
+    for (int i = 0; i < count; ++i) {
+        uint32_t gap = edits[i].voxel - previous;
+        save_buffer_append(buffer, &gap, sizeof(gap));
+        previous = edits[i].voxel;
     }
+    for (int i = 0; i < count; ++i) {
+        save_buffer_append(buffer, &edits[i].block, sizeof(edits[i].block));
+    }
+}
 
+/* Replaces the chunk's edits; on failure it is left with none. Voxels index
+ * BLOCK_REGISTRY directly, so loaded IDs are range checked here. */
+static bool save_decode_edits(const uint8_t *data, size_t size, Chunk *chunk) {
+    SaveReader reader = {.data = data, .size = size};
+    chunk->edit_count = 0;
+    
+    uint32_t stored;
+    if (!save_read(&reader, &stored, sizeof(stored)) || stored > CHUNK_VOXELS ||
+        size - reader.pos != (size_t)stored * (sizeof(uint32_t) + sizeof(BlockId))) {
+        return false;
+    }
+    chunk_reserve_edits(chunk, (int)stored);
+    
+    /* Indices strictly increase, the first may be 0 */
+    uint64_t voxel = 0;
+    for (uint32_t i = 0; i < stored; ++i) {
+        uint32_t gap;
+        if (!save_read(&reader, &gap, sizeof(gap))) return false;
+        voxel += gap;
+        if ((i > 0 && gap == 0) || voxel >= CHUNK_VOXELS) return false;
+        chunk->edits[i] = (ChunkEdit){.voxel = (uint32_t)voxel};
+    }
+    for (uint32_t i = 0; i < stored; ++i) {
+        BlockId block;
+        if (!save_read(&reader, &block, sizeof(block)) || !block_id_valid(block)) return false;
+        chunk->edits[i].block = block;
+    }
+    
+    chunk->edit_count = (int)stored;
     return true;
 }
 
 /* -------------------------------------------------------------------------- */
-/* Chunk Operations                                                           */
+/* Record Compression                                                         */
 /* -------------------------------------------------------------------------- */
 
-static void chunk_ensure_capacity(Chunk *chunk, int min_capacity) {
-    if (chunk->block_capacity >= min_capacity) return;
+/* Compressed records start with their raw size, so decoding allocates once */
+typedef uint32_t SaveRawSize;
+
+/* Largest stored record, with room for codec overhead on incompressible data */
+#define REGION_MAX_STORED \
+    (sizeof(SaveRawSize) + REGION_MAX_RECORD + REGION_MAX_RECORD / 64 + 64)
+
+/* RLE control byte: 0..127 is a literal of c + 1 bytes, 128..255 repeats the
+ * next byte c - 125 times. Edit records run on the high bytes of small gaps
+ * and on blocks placed in a row. */
+#define RLE_MAX_LITERAL 128
+#define RLE_MIN_RUN 3
+#define RLE_MAX_RUN 130
+
+static void rle_compress(const uint8_t *src, size_t size, SaveBuffer *out) {
+    size_t i = 0, literal = 0;
+    while (i < size) {
+        size_t run = 1;
+        while (i + run < size && run < RLE_MAX_RUN && src[i + run] == src[i]) ++run;
+        
+        if (run >= RLE_MIN_RUN) {
+            uint8_t control = (uint8_t)(run + 125);
+            save_buffer_append(out, &control, 1);
+            save_buffer_append(out, &src[i], 1);
+            i += run;
+            continue;
+        }
+        
+        /* Literal up to the next run worth encoding */
+        literal = i;
+        while (i < size && i - literal < RLE_MAX_LITERAL) {
+            if (i + 2 < size && src[i] == src[i + 1] && src[i] == src[i + 2]) break;
+            ++i;
+        }
+        uint8_t control = (uint8_t)(i - literal - 1);
+        save_buffer_append(out, &control, 1);
+        save_buffer_append(out, &src[literal], i - literal);
+    }
+}
+
+static bool rle_decompress(const uint8_t *src, size_t size, uint8_t *dst, size_t raw_size) {
+    size_t i = 0, o = 0;
+    while (i < size) {
+        unsigned control = src[i++];
+        if (control < RLE_MAX_LITERAL) {
+            size_t count = control + 1u;
+            if (size - i < count || raw_size - o < count) return false;
+            memcpy(&dst[o], &src[i], count);
+            i += count;
+            o += count;
+        } else {
+            size_t count = control - 125u;
+            if (i >= size || raw_size - o < count) return false;
+            memset(&dst[o], src[i++], count);
+            o += count;
+        }
+    }
+    return o == raw_size;
+}
+
+/* Appends `raw` to out in the given codec */
+static void save_compress(SaveCodec codec, const SaveBuffer *raw, SaveBuffer *out) {
+    if (codec == SAVE_CODEC_NONE) {
+        save_buffer_append(out, raw->data, raw->size);
+        return;
+    }
     
-    int new_cap = chunk->block_capacity > 0 ? chunk->block_capacity : 256;
-    while (new_cap < min_capacity) new_cap *= 2;
+    SaveRawSize raw_size = (SaveRawSize)raw->size;
+    save_buffer_append(out, &raw_size, sizeof(raw_size));
     
-    Block *new_blocks = realloc(chunk->blocks, (size_t)new_cap * sizeof(Block));
-    if (!new_blocks) die("Failed to allocate chunk blocks");
+    if (codec == SAVE_CODEC_RLE) {
+        rle_compress(raw->data, raw->size, out);
+        return;
+    }
     
-    chunk->blocks = new_blocks;
-    chunk->block_capacity = new_cap;
+    uLongf packed = compressBound((uLong)raw->size);
+    save_buffer_reserve(out, packed);
+    if (compress2(out->data + out->size, &packed, raw->data, (uLong)raw->size, Z_DEFAULT_COMPRESSION) != Z_OK) {
+        die("Failed to compress save record");
+    }
+    out->size += packed;
 }
 
-static void chunk_init(Chunk *chunk, int cx, int cz) {
-    chunk->cx = cx;
-    chunk->cz = cz;
-    chunk->block_count = 0;
-    chunk->block_capacity = 0;
-    chunk->blocks = NULL;
-    chunk->dirty = false;
-    chunk->render_dirty = true;
+/* Restores a record written by save_compress into out, replacing its contents */
+static bool save_decompress(SaveCodec codec, const uint8_t *data, size_t size, SaveBuffer *out) {
+    out->size = 0;
+    if (codec == SAVE_CODEC_NONE) {
+        save_buffer_append(out, data, size);
+        return true;
+    }
+    
+    SaveRawSize raw_size;
+    if (size < sizeof(raw_size)) return false;
+    memcpy(&raw_size, data, sizeof(raw_size));
+    if (raw_size > REGION_MAX_RECORD) return false;
+    data += sizeof(raw_size);
+    size -= sizeof(raw_size);
     
-    size_t voxel_size = chunk_voxel_count();
-    chunk->voxels = malloc(voxel_size);
-    if (!chunk->voxels) die("Failed to allocate chunk voxels");
-    memset(chunk->voxels, 255, voxel_size);
+    save_buffer_reserve(out, raw_size);
+    out->size = raw_size;
+    if (codec == SAVE_CODEC_RLE) return rle_decompress(data, size, out->data, raw_size);
+    
+    uLongf unpacked = raw_size;
+    return uncompress(out->data, &unpacked, data, (uLong)size) == Z_OK && unpacked == raw_size;
 }
 
-static void chunk_destroy(Chunk *chunk) {
-    if (!chunk) return;
-    free(chunk->voxels);
-    free(chunk->blocks);
-    free(chunk);
-}
+/* -------------------------------------------------------------------------- */
+/* Region Files                                                               */
+/* -------------------------------------------------------------------------- */
 
-static inline bool chunk_in_bounds(int lx, int ly, int lz) {
-    return lx >= 0 && lx < CHUNK_SIZE &&
-           lz >= 0 && lz < CHUNK_SIZE &&
-           ly >= 0 && ly < CHUNK_HEIGHT;
+typedef struct {
+    uint32_t sector;    /* First sector of the record; 0 when the chunk is not saved */
+    uint32_t length;    /* Record bytes */
+} RegionEntry;
+
+/* Regions carry the layout and terrain they were written with, so files
+ * from a build with another height or generator are set aside like a
+ * mismatched level file */
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    int32_t min_y;
+    int32_t max_y;
+    uint32_t generator_version;
+    uint32_t generator_hash;
+    uint32_t codec;         /* SaveCodec of every record in the file */
+    RegionEntry entries[REGION_CHUNKS];
+} RegionHeader;
+
+static uint32_t generator_hash(void);
+
+#define REGION_HEADER_SECTORS \
+    ((uint32_t)((sizeof(RegionHeader) + REGION_SECTOR_SIZE - 1) / REGION_SECTOR_SIZE))
+
+struct SaveRegion {
+    int rx;
+    int rz;
+    int fd;                 /* -1 until the region file exists */
+    uint64_t last_use;
+    bool pinned;            /* Writer batch in progress; never evicted */
+    RegionHeader header;
+    
+    /* Sector occupancy, so rewritten records reuse freed runs */
+    uint8_t *used;
+    uint32_t sector_count;
+    uint32_t used_capacity;
+};
+
+static void region_path(const WorldSave *save, int rx, int rz, char *out, size_t size) {
+    snprintf(out, size, "%s/r.%d.%d.vxr", save->path, rx, rz);
 }
 
-static uint8_t chunk_get_voxel(const Chunk *chunk, int lx, int ly, int lz) {
-    return chunk_in_bounds(lx, ly, lz) ? chunk->voxels[voxel_index(lx, ly, lz)] : 255;
+/* Save files from a build with another layout or terrain generator are
+ * renamed to <path>.old (then .old1, .old2, ...) and never written, so a
+ * matching build can still open them. The save goes on as if they were
+ * missing. */
+static void save_set_aside(const char *path) {
+    char aside[320];
+    for (int n = 0;; ++n) {
+        if (n == 0) snprintf(aside, sizeof(aside), "%s.old", path);
+        else snprintf(aside, sizeof(aside), "%s.old%d", path, n);
+        if (access(aside, F_OK) != 0) break;
+    }
+    
+    if (rename(path, aside) != 0) die("Failed to set aside save file from another build");
+    fprintf(stderr, "Warning: %s is from another build or terrain generator; moved to %s\n",
+            path, aside);
 }
 
-static void chunk_set_voxel(Chunk *chunk, int lx, int ly, int lz, uint8_t type) {
-    if (chunk_in_bounds(lx, ly, lz)) {
-        chunk->voxels[voxel_index(lx, ly, lz)] = type;
+static void region_mark(SaveRegion *region, uint32_t sector, uint32_t count, bool used) {
+    if (sector + count > region->used_capacity) {
+        uint32_t new_cap = region->used_capacity > 0 ? region->used_capacity : 256;
+        while (new_cap < sector + count) new_cap *= 2;
+        
+        uint8_t *new_used = realloc(region->used, new_cap);
+        if (!new_used) die("Failed to allocate region sector map");
+        memset(new_used + region->used_capacity, 0, new_cap - region->used_capacity);
+        region->used = new_used;
+        region->used_capacity = new_cap;
     }
+    memset(region->used + sector, used, count);
+    if (used && sector + count > region->sector_count) region->sector_count = sector + count;
 }
 
-static IVec3 chunk_local_to_world(const Chunk *chunk, int lx, int ly, int lz) {
-    return (IVec3){
-        chunk_to_base(chunk->cx) + lx,
-        WORLD_MIN_Y + ly,
-        chunk_to_base(chunk->cz) + lz
-    };
+static uint32_t region_sectors_for(uint32_t length) {
+    return (length + REGION_SECTOR_SIZE - 1) / REGION_SECTOR_SIZE;
 }
 
-static bool chunk_world_to_local(const Chunk *chunk, IVec3 pos, int *lx, int *ly, int *lz) {
-    if (!world_y_in_bounds(pos.y)) return false;
-    
-    *lx = pos.x - chunk_to_base(chunk->cx);
-    *lz = pos.z - chunk_to_base(chunk->cz);
-    *ly = pos.y - WORLD_MIN_Y;
-    
-    return chunk_in_bounds(*lx, *ly, *lz);
+/* First free run of `count` sectors, or the end of the file */
+static uint32_t region_find_run(const SaveRegion *region, uint32_t count) {
+    uint32_t run = 0;
+    for (uint32_t s = REGION_HEADER_SECTORS; s < region->sector_count; ++s) {
+        run = region->used[s] ? 0 : run + 1;
+        if (run == count) return s + 1 - count;
+    }
+    return region->sector_count - run;
 }
 
-static void chunk_generate(World *world, Chunk *chunk);
-
-static void chunk_rebuild_render_list(World *world, Chunk *chunk) {
-    chunk->block_count = 0;
-    
-    int base_x = chunk_to_base(chunk->cx);
-    int base_z = chunk_to_base(chunk->cz);
+/* Reads the offset table of an existing region file; entries that point
+ * outside the file or overlap an earlier one are dropped. False when the
+ * file is from a build with another layout or generator: its chunks are
+ * edits over other terrain and must be neither read nor overwritten. */
+static bool region_read_header(SaveRegion *region) {
+    RegionHeader *header = &region->header;
+    ssize_t got = pread(region->fd, header, sizeof(*header), 0);
+    if (got != (ssize_t)sizeof(*header) || header->magic != WORLD_REGION_MAGIC) {
+        memset(header, 0, sizeof(*header));
+        return true;
+    }
+    if (header->version != WORLD_SAVE_VERSION ||
+        header->min_y != WORLD_MIN_Y || header->max_y != WORLD_MAX_Y ||
+        header->generator_version != WORLD_GENERATOR_VERSION ||
+        header->generator_hash != generator_hash() ||
+        header->codec >= SAVE_CODEC_COUNT) {
+        memset(header, 0, sizeof(*header));
+        return false;
+    }
+    
+    struct stat st;
+    uint64_t file_sectors = fstat(region->fd, &st) == 0 ?
+        ((uint64_t)st.st_size + REGION_SECTOR_SIZE - 1) / REGION_SECTOR_SIZE : 0;
+    
+    for (int i = 0; i < REGION_CHUNKS; ++i) {
+        RegionEntry *entry = &header->entries[i];
+        if (entry->sector == 0) continue;
+        
+        uint32_t count = region_sectors_for(entry->length);
+        bool valid = entry->sector >= REGION_HEADER_SECTORS &&
+                     entry->length > 0 && entry->length <= REGION_MAX_STORED &&
+                     (uint64_t)entry->sector + count <= file_sectors;
+        for (uint32_t s = 0; valid && s < count; ++s) {
+            valid = entry->sector + s >= region->sector_count || !region->used[entry->sector + s];
+        }
+        
+        if (valid) region_mark(region, entry->sector, count, true);
+        else *entry = (RegionEntry){0};
+    }
+    return true;
+}
+
+static void region_close(SaveRegion *region) {
+    if (region->fd >= 0) close(region->fd);
+    free(region->used);
+    free(region);
+}
+
+/* Cached region holding chunk (rx, rz); only the offset table is read.
+ * The writer pins at most one region, so an unpinned slot always exists. */
+static SaveRegion *save_region(WorldSave *save, int rx, int rz) {
+    int slot = -1;
+    for (int i = 0; i < REGION_CACHE_SIZE; ++i) {
+        SaveRegion *region = save->regions[i];
+        if (region && region->rx == rx && region->rz == rz) {
+            region->last_use = ++save->region_clock;
+            return region;
+        }
+        if (!region) slot = i;
+        else if (region->pinned) continue;
+        else if (slot < 0 || (save->regions[slot] && region->last_use < save->regions[slot]->last_use)) slot = i;
+    }
+    
+    if (save->regions[slot]) region_close(save->regions[slot]);
+    
+    SaveRegion *region = calloc(1, sizeof(SaveRegion));
+    if (!region) die("Failed to allocate save region");
+    region->rx = rx;
+    region->rz = rz;
+    region->sector_count = REGION_HEADER_SECTORS;
+    region->last_use = ++save->region_clock;
+    
+    char path[300];
+    region_path(save, rx, rz, path, sizeof(path));
+    region->fd = open(path, O_RDWR);
+    if (region->fd >= 0 && !region_read_header(region)) {
+        close(region->fd);
+        region->fd = -1;
+        save_set_aside(path);
+    }
+    
+    save->regions[slot] = region;
+    return region;
+}
+
+/* Table index of chunk (cx, cz) within its region */
+static int region_chunk_index(int cx, int cz) {
+    return (cz - floor_div(cz, REGION_SIZE) * REGION_SIZE) * REGION_SIZE +
+           (cx - floor_div(cx, REGION_SIZE) * REGION_SIZE);
+}
+
+static SaveRegion *save_chunk_region(WorldSave *save, int cx, int cz, int *out_index) {
+    *out_index = region_chunk_index(cx, cz);
+    return save_region(save, floor_div(cx, REGION_SIZE), floor_div(cz, REGION_SIZE));
+}
+
+/* Codec of records written to the region: its own, or the build's for a new file */
+static SaveCodec region_codec(const SaveRegion *region) {
+    return region->header.magic == WORLD_REGION_MAGIC ? (SaveCodec)region->header.codec : WORLD_SAVE_CODEC;
+}
+
+/* Reads the chunk's stored record into out; false when it has none */
+static bool region_read_record(SaveRegion *region, int index, SaveBuffer *out) {
+    const RegionEntry *entry = &region->header.entries[index];
+    if (region->fd < 0 || entry->sector == 0) return false;
+    
+    out->size = 0;
+    save_buffer_reserve(out, entry->length);
+    out->size = entry->length;
+    return pread(region->fd, out->data, entry->length,
+                 (off_t)entry->sector * REGION_SECTOR_SIZE) == (ssize_t)entry->length;
+}
+
+/* Writes a record to free sectors, leaving the chunk's current record and
+ * table entry alone until region_commit_entry switches to it */
+static RegionEntry region_put_record(WorldSave *save, SaveRegion *region,
+                                     const uint8_t *data, uint32_t length) {
+    if (region->fd < 0) {
+        char path[300];
+        region_path(save, region->rx, region->rz, path, sizeof(path));
+        region->fd = open(path, O_RDWR | O_CREAT, 0644);
+        if (region->fd < 0) die("Failed to create region file");
+    }
+    
+    /* New files, and files whose table was unreadable, start over empty */
+    RegionHeader *header = &region->header;
+    if (header->magic != WORLD_REGION_MAGIC) {
+        *header = (RegionHeader){
+            .magic = WORLD_REGION_MAGIC,
+            .version = WORLD_SAVE_VERSION,
+            .min_y = WORLD_MIN_Y,
+            .max_y = WORLD_MAX_Y,
+            .generator_version = WORLD_GENERATOR_VERSION,
+            .generator_hash = generator_hash(),
+            .codec = WORLD_SAVE_CODEC
+        };
+        if (pwrite(region->fd, header, sizeof(*header), 0) != (ssize_t)sizeof(*header)) {
+            die("Failed to write region header");
+        }
+    }
+    
+    uint32_t count = region_sectors_for(length);
+    uint32_t sector = region_find_run(region, count);
+    if (pwrite(region->fd, data, length, (off_t)sector * REGION_SECTOR_SIZE) != (ssize_t)length) {
+        die("Failed to write save record");
+    }
+    region_mark(region, sector, count, true);
+    return (RegionEntry){.sector = sector, .length = length};
+}
+
+/* Points the chunk's table entry at a record written by region_put_record
+ * and frees the sectors of the record it replaces. The region must have
+ * stayed open since the put, or its map would have lost the new record. */
+static void region_commit_entry(SaveRegion *region, int index, RegionEntry entry) {
+    RegionEntry *current = &region->header.entries[index];
+    RegionEntry old = *current;
+    
+    *current = entry;
+    
+    off_t offset = (off_t)offsetof(RegionHeader, entries) + (off_t)index * (off_t)sizeof(RegionEntry);
+    if (pwrite(region->fd, current, sizeof(*current), offset) != (ssize_t)sizeof(*current)) {
+        die("Failed to write region table");
+    }
+    
+    if (old.sector != 0 && old.sector != entry.sector) {
+        region_mark(region, old.sector, region_sectors_for(old.length), false);
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+/* World Save                                                                 */
+/* -------------------------------------------------------------------------- */
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t chunk_size;
+    int32_t min_y;
+    int32_t max_y;
+    uint32_t region_size;
+    uint32_t generator_version;
+    uint32_t generator_hash;
+} LevelHeader;
+
+static void level_path(const WorldSave *save, char *out, size_t size) {
+    snprintf(out, size, "%s/level.vox", save->path);
+}
+
+static void *save_writer_main(void *arg);
+
+void world_save_init(WorldSave *save, const char *path) {
+    memset(save, 0, sizeof(*save));
+    snprintf(save->path, sizeof(save->path), "%s", path);
+    if (mkdir(save->path, 0755) != 0 && errno != EEXIST) die("Failed to create save directory");
+    
+    if (pthread_mutex_init(&save->lock, NULL) != 0 ||
+        pthread_mutex_init(&save->region_lock, NULL) != 0 ||
+        pthread_cond_init(&save->writer_wake, NULL) != 0 ||
+        pthread_cond_init(&save->writer_idle, NULL) != 0) {
+        die("Failed to initialize save lock");
+    }
+    if (pthread_create(&save->writer, NULL, save_writer_main, save) != 0) {
+        die("Failed to start save writer");
+    }
+}
+
+/* Reads the level header and player; chunks are read from their regions on
+ * demand, so opening a save costs the same however much has been explored */
+bool world_save_load(WorldSave *save) {
+    char path[300];
+    level_path(save, path, sizeof(path));
+    
+    FILE *f = fopen(path, "rb");
+    if (!f) return false;
+    
+    LevelHeader header;
+    if (fread(&header, sizeof(header), 1, f) != 1 || header.magic != WORLD_SAVE_MAGIC) {
+        fclose(f);
+        return false;
+    }
+    
+    /* Region files are checked the same way as they are opened */
+    if (header.version != WORLD_SAVE_VERSION ||
+        header.chunk_size != CHUNK_SIZE ||
+        header.min_y != WORLD_MIN_Y ||
+        header.max_y != WORLD_MAX_Y ||
+        header.region_size != REGION_SIZE ||
+        header.generator_version != WORLD_GENERATOR_VERSION ||
+        header.generator_hash != generator_hash()) {
+        fclose(f);
+        save_set_aside(path);
+        return false;
+    }
+
+    /* Load player data */
+    save->has_player_data = false;
+    if (fread(&save->player_position.x, sizeof(float), 1, f) == 1 &&
+        fread(&save->player_position.y, sizeof(float), 1, f) == 1 &&
+        fread(&save->player_position.z, sizeof(float), 1, f) == 1 &&
+        fread(&save->player_health, sizeof(uint8_t), 1, f) == 1 &&
+        fread(&save->player_selected_slot, sizeof(uint8_t), 1, f) == 1 &&
+        fread(save->player_inventory, sizeof(BlockId), 27, f) == 27 &&
+        fread(save->player_inventory_counts, sizeof(uint8_t), 27, f) == 27) {
+        save->has_player_data = true;
+        for (int i = 0; i < 27; ++i) {
+            if (!block_id_valid(save->player_inventory[i])) save->has_player_data = false;
+        }
+    }
+    
+    fclose(f);
+    return save->has_player_data;
+}
+
+/* Position, health, selected slot and inventory, as read by world_save_load */
+static void save_encode_player(const WorldSave *save, SaveBuffer *buffer) {
+    save_buffer_append(buffer, &save->player_position.x, sizeof(float));
+    save_buffer_append(buffer, &save->player_position.y, sizeof(float));
+    save_buffer_append(buffer, &save->player_position.z, sizeof(float));
+    save_buffer_append(buffer, &save->player_health, sizeof(uint8_t));
+    save_buffer_append(buffer, &save->player_selected_slot, sizeof(uint8_t));
+    save_buffer_append(buffer, save->player_inventory, sizeof(save->player_inventory));
+    save_buffer_append(buffer, save->player_inventory_counts, sizeof(save->player_inventory_counts));
+}
+
+/* Writer thread: the level file is small and replaced whole through a temp
+ * file that is synced before the rename, so a crash leaves the old or the
+ * new player, never a mix */
+static void save_write_level(const WorldSave *save, const uint8_t *player, size_t player_size) {
+    char path[300], tmp_path[310];
+    level_path(save, path, sizeof(path));
+    snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", path);
+    
+    FILE *f = fopen(tmp_path, "wb");
+    if (!f) die("Failed to open temp save file");
+    
+    LevelHeader header = {
+        .magic = WORLD_SAVE_MAGIC,
+        .version = WORLD_SAVE_VERSION,
+        .chunk_size = CHUNK_SIZE,
+        .min_y = WORLD_MIN_Y,
+        .max_y = WORLD_MAX_Y,
+        .region_size = REGION_SIZE,
+        .generator_version = WORLD_GENERATOR_VERSION,
+        .generator_hash = generator_hash()
+    };
+    bool ok = fwrite(&header, sizeof(header), 1, f) == 1 &&
+              fwrite(player, 1, player_size, f) == player_size &&
+              fflush(f) == 0 && fsync(fileno(f)) == 0;
+    fclose(f);
+    
+    if (!ok) {
+        remove(tmp_path);
+        die("Failed to write save header");
+    }
+    if (rename(tmp_path, path) != 0) {
+        remove(tmp_path);
+        die("Failed to replace save file");
+    }
+    
+    int dir = open(save->path, O_RDONLY);
+    if (dir >= 0) {
+        fsync(dir);
+        close(dir);
+    }
+}
+
+static int record_region_compare(const void *a, const void *b) {
+    const ChunkRecord *ra = a, *rb = b;
+    int ax = floor_div(ra->cx, REGION_SIZE), az = floor_div(ra->cz, REGION_SIZE);
+    int bx = floor_div(rb->cx, REGION_SIZE), bz = floor_div(rb->cz, REGION_SIZE);
+    if (az != bz) return az < bz ? -1 : 1;
+    if (ax != bx) return ax < bx ? -1 : 1;
+    return 0;
+}
+
+/* Writer thread: records of one region are written to free sectors and
+ * synced before any table entry points at them, then the entries are
+ * switched and synced. A chunk whose edits were all undone gets an empty
+ * entry, freeing its sectors. Region I/O holds region_lock only around the
+ * writes, never across an fsync. */
+static void save_write_region_records(WorldSave *save, const ChunkRecord *records, int count) {
+    SaveBuffer raw = {0}, packed = {0};
+    RegionEntry *entries = malloc((size_t)count * sizeof(RegionEntry));
+    if (!entries) die("Failed to allocate save batch");
+    
+    /* Pinned until the entries are committed: a reopened region would
+     * rebuild its sector map from the table on disk, which does not yet
+     * hold the batch, and hand the batch's sectors out again. Only this
+     * thread creates region files, so the codec cannot change. */
+    int index;
+    pthread_mutex_lock(&save->region_lock);
+    SaveRegion *region = save_chunk_region(save, records[0].cx, records[0].cz, &index);
+    region->pinned = true;
+    SaveCodec codec = region_codec(region);
+    pthread_mutex_unlock(&save->region_lock);
+    
+    int sync_fd = -1;
+    for (int i = 0; i < count; ++i) {
+        entries[i] = (RegionEntry){0};
+        if (records[i].edit_count > 0) {
+            raw.size = 0;
+            packed.size = 0;
+            save_encode_edits(records[i].edits, records[i].edit_count, &raw);
+            save_compress(codec, &raw, &packed);
+            
+            pthread_mutex_lock(&save->region_lock);
+            region->last_use = ++save->region_clock;
+            entries[i] = region_put_record(save, region, packed.data, (uint32_t)packed.size);
+            pthread_mutex_unlock(&save->region_lock);
+        }
+    }
+    free(raw.data);
+    free(packed.data);
+    
+    pthread_mutex_lock(&save->region_lock);
+    if (region->fd >= 0) sync_fd = dup(region->fd);
+    pthread_mutex_unlock(&save->region_lock);
+    
+    /* Only undone edits of chunks the region never held: nothing to write */
+    if (sync_fd >= 0) {
+        if (fsync(sync_fd) != 0) die("Failed to sync region file");
+        
+        pthread_mutex_lock(&save->region_lock);
+        for (int i = 0; i < count; ++i) {
+            region_commit_entry(region, region_chunk_index(records[i].cx, records[i].cz), entries[i]);
+        }
+        pthread_mutex_unlock(&save->region_lock);
+        
+        if (fsync(sync_fd) != 0) die("Failed to sync region file");
+        close(sync_fd);
+    }
+    
+    pthread_mutex_lock(&save->region_lock);
+    region->pinned = false;
+    pthread_mutex_unlock(&save->region_lock);
+    free(entries);
+}
+
+static void save_write_batch(WorldSave *save) {
+    if (save->writing_player) {
+        save_write_level(save, save->writing_player, save->writing_player_size);
+    }
+    
+    /* Sorted by region at hand-off, so each region is one run */
+    for (int start = 0; start < save->writing_count;) {
+        int end = start + 1;
+        while (end < save->writing_count &&
+               record_region_compare(&save->writing[start], &save->writing[end]) == 0) {
+            ++end;
+        }
+        save_write_region_records(save, &save->writing[start], end - start);
+        start = end;
+    }
+}
+
+static void *save_writer_main(void *arg) {
+    WorldSave *save = arg;
+    
+    pthread_mutex_lock(&save->lock);
+    for (;;) {
+        while (!save->writer_busy && !save->writer_stop) {
+            pthread_cond_wait(&save->writer_wake, &save->lock);
+        }
+        if (!save->writer_busy) break;
+        
+        /* The batch is read-only while busy; loads may copy from it */
+        pthread_mutex_unlock(&save->lock);
+        save_write_batch(save);
+        pthread_mutex_lock(&save->lock);
+        
+        records_clear(save->writing, &save->writing_count);
+        free(save->writing_player);
+        save->writing_player = NULL;
+        save->writer_busy = false;
+        pthread_cond_broadcast(&save->writer_idle);
+    }
+    pthread_mutex_unlock(&save->lock);
+    return NULL;
+}
+
+/* Hands the stored chunks and a copy of the player block to the writer and
+ * returns at once. While a batch is still being written, this flush's work
+ * waits for the next one rather than blocking the caller. */
+void world_save_flush(WorldSave *save) {
+    pthread_mutex_lock(&save->lock);
+    if (save->writer_busy || (save->count == 0 && !save->player_dirty)) {
+        pthread_mutex_unlock(&save->lock);
+        return;
+    }
+    
+    /* Swap the lists: stored records become the batch without copying */
+    ChunkRecord *records = save->writing;
+    int capacity = save->writing_capacity;
+    save->writing = save->records;
+    save->writing_count = save->count;
+    save->writing_capacity = save->capacity;
+    save->records = records;
+    save->count = 0;
+    save->capacity = capacity;
+    qsort(save->writing, (size_t)save->writing_count, sizeof(ChunkRecord), record_region_compare);
+    
+    if (save->player_dirty) {
+        SaveBuffer player = {0};
+        save_encode_player(save, &player);
+        save->writing_player = player.data;
+        save->writing_player_size = player.size;
+        save->player_dirty = false;
+    }
+    
+    save->writer_busy = true;
+    pthread_cond_signal(&save->writer_wake);
+    pthread_mutex_unlock(&save->lock);
+}
+
+void world_save_sync(WorldSave *save) {
+    /* Two rounds: a batch already in progress, then whatever it held back */
+    for (int round = 0; round < 2; ++round) {
+        world_save_flush(save);
+        pthread_mutex_lock(&save->lock);
+        while (save->writer_busy) pthread_cond_wait(&save->writer_idle, &save->lock);
+        pthread_mutex_unlock(&save->lock);
+    }
+}
+
+void world_save_destroy(WorldSave *save) {
+    world_save_sync(save);
+    
+    pthread_mutex_lock(&save->lock);
+    save->writer_stop = true;
+    pthread_cond_signal(&save->writer_wake);
+    pthread_mutex_unlock(&save->lock);
+    pthread_join(save->writer, NULL);
+    
+    records_clear(save->records, &save->count);
+    free(save->records);
+    free(save->writing);
+    for (int i = 0; i < REGION_CACHE_SIZE; ++i) {
+        if (save->regions[i]) region_close(save->regions[i]);
+    }
+    pthread_cond_destroy(&save->writer_wake);
+    pthread_cond_destroy(&save->writer_idle);
+    pthread_mutex_destroy(&save->region_lock);
+    pthread_mutex_destroy(&save->lock);
+    memset(save, 0, sizeof(*save));
+}
+
+static void save_store_chunk(WorldSave *save, const Chunk *chunk) {
+    pthread_mutex_lock(&save->lock);
+    
+    int idx = records_find(save->records, save->count, chunk->cx, chunk->cz);
+    
+    if (idx < 0) {
+        save_ensure_capacity(save, save->count + 1);
+        idx = save->count++;
+        save->records[idx] = (ChunkRecord){.cx = chunk->cx, .cz = chunk->cz};
+    }
+    
+    ChunkRecord *record = &save->records[idx];
+    free(record->edits);
+    record->edits = NULL;
+    record->edit_count = chunk->edit_count;
+    if (chunk->edit_count > 0) {
+        size_t size = (size_t)chunk->edit_count * sizeof(ChunkEdit);
+        record->edits = malloc(size);
+        if (!record->edits) die("Failed to store chunk edits");
+        memcpy(record->edits, chunk->edits, size);
+    }
+    
+    pthread_mutex_unlock(&save->lock);
+}
+
+/* Loads the chunk's saved edits; false when it has none saved. Safe to call
+ * from chunk load workers. Stored and in-flight records are newer than the
+ * region copy; once a batch is retired its chunks are in their regions, so
+ * a miss in both lists can read the region. */
+static bool save_load_chunk(WorldSave *save, Chunk *chunk) {
+    pthread_mutex_lock(&save->lock);
+    
+    const ChunkRecord *record = NULL;
+    int idx = records_find(save->records, save->count, chunk->cx, chunk->cz);
+    if (idx >= 0) {
+        record = &save->records[idx];
+    } else if ((idx = records_find(save->writing, save->writing_count, chunk->cx, chunk->cz)) >= 0) {
+        record = &save->writing[idx];
+    }
+    if (record) {
+        chunk_reserve_edits(chunk, record->edit_count);
+        if (record->edit_count > 0) {
+            memcpy(chunk->edits, record->edits, (size_t)record->edit_count * sizeof(ChunkEdit));
+        }
+        chunk->edit_count = record->edit_count;
+    }
+    
+    pthread_mutex_unlock(&save->lock);
+    if (record) return true;
     
-    static const IVec3 neighbors[6] = {
-        {1, 0, 0}, {-1, 0, 0}, {0, 1, 0}, {0, -1, 0}, {0, 0, 1}, {0, 0, -1}
+    /* Only the read holds the region lock; decoding runs alongside other loads */
+    SaveBuffer stored = {0}, raw = {0};
+    pthread_mutex_lock(&save->region_lock);
+    int index;
+    SaveRegion *region = save_chunk_region(save, chunk->cx, chunk->cz, &index);
+    SaveCodec codec = region_codec(region);
+    bool found = region_read_record(region, index, &stored);
+    pthread_mutex_unlock(&save->region_lock);
+    
+    found = found && save_decompress(codec, stored.data, stored.size, &raw) &&
+            save_decode_edits(raw.data, raw.size, chunk);
+    free(stored.data);
+    free(raw.data);
+    return found;
+}
+
+void world_save_store_player(WorldSave *save, const Player *player) {
+    if (!save || !player) return;
+
+    /* An idle player leaves the block as it is and autosaves write nothing */
+    bool changed = !save->has_player_data ||
+                   save->player_position.x != player->position.x ||
+                   save->player_position.y != player->position.y ||
+                   save->player_position.z != player->position.z ||
+                   save->player_health != player->health ||
+                   save->player_selected_slot != player->selected_slot;
+    for (int i = 0; i < 27 && !changed; ++i) {
+        changed = save->player_inventory[i] != player->inventory[i] ||
+                  save->player_inventory_counts[i] != player->inventory_counts[i];
+    }
+    if (!changed) return;
+
+    save->player_position = player->position;
+    save->player_health = player->health;
+    save->player_selected_slot = player->selected_slot;
+
+    for (int i = 0; i < 27; ++i) {
+        save->player_inventory[i] = player->inventory[i];
+        save->player_inventory_counts[i] = player->inventory_counts[i];
+    }
+
+    save->has_player_data = true;
+    save->player_dirty = true;
+}
+
+bool world_save_load_player(const WorldSave *save, Player *player) {
+    if (!save || !player || !save->has_player_data) return false;
+
+    player->position = save->player_position;
+    player->health = save->player_health;
+    player->selected_slot = save->player_selected_slot;
+
+    for (int i = 0; i < 27; ++i) {
+        player->inventory[i] = save->player_inventory[i];
+        player->inventory_counts[i] = save->player_inventory_counts[i];
+    }
+
+    return true;
+}
+
+/* -------------------------------------------------------------------------- */
+/* Thread Scratch                                                             */
+/* -------------------------------------------------------------------------- */
+
+/* Meshing and generation work in buffers that grow with CHUNK_HEIGHT, too
+ * large for worker stacks at tall build heights. Each thread allocates one
+ * of each kind on first use and keeps it until it exits. */
+typedef enum {
+    SCRATCH_MESH,
+    SCRATCH_GEN,
+    SCRATCH_COUNT
+} ScratchKind;
+
+static pthread_once_t scratch_once = PTHREAD_ONCE_INIT;
+static pthread_key_t scratch_keys[SCRATCH_COUNT];
+
+static void scratch_init_once(void) {
+    for (int i = 0; i < SCRATCH_COUNT; ++i) {
+        if (pthread_key_create(&scratch_keys[i], free) != 0) die("Failed to create thread scratch");
+    }
+}
+
+/* The calling thread's `size`-byte block of this kind; contents are left
+ * from its last use */
+static void *thread_scratch(ScratchKind kind, size_t size) {
+    pthread_once(&scratch_once, scratch_init_once);
+    
+    void *scratch = pthread_getspecific(scratch_keys[kind]);
+    if (!scratch) {
+        scratch = malloc(size);
+        if (!scratch || pthread_setspecific(scratch_keys[kind], scratch) != 0) {
+            die("Failed to allocate thread scratch");
+        }
+    }
+    return scratch;
+}
+
+/* -------------------------------------------------------------------------- */
+/* Chunk Operations                                                           */
+/* -------------------------------------------------------------------------- */
+
+static void chunk_ensure_capacity(Chunk *chunk, int min_capacity) {
+    if (chunk->block_capacity >= min_capacity) return;
+    
+    int new_cap = chunk->block_capacity > 0 ? chunk->block_capacity : 256;
+    while (new_cap < min_capacity) new_cap *= 2;
+    
+    Block *new_blocks = arena_realloc(chunk->blocks, (size_t)chunk->block_capacity * sizeof(Block),
+                                      (size_t)new_cap * sizeof(Block));
+    if (!new_blocks) die("Failed to allocate chunk blocks");
+    
+    chunk->blocks = new_blocks;
+    chunk->block_capacity = new_cap;
+}
+
+static void chunk_init(Chunk *chunk, int cx, int cz) {
+    chunk->cx = cx;
+    chunk->cz = cz;
+    chunk->block_count = 0;
+    chunk->block_capacity = 0;
+    chunk->blocks = NULL;
+    memset(chunk->face_counts, 0, sizeof(chunk->face_counts));
+    memset(chunk->face_slots, 0, sizeof(chunk->face_slots));
+    memset(chunk->neighbors, 0, sizeof(chunk->neighbors));
+    chunk->state = CHUNK_STATE_GENERATED;
+    chunk->mesh_vertices = NULL;
+    chunk->mesh_vertex_count = 0;
+    chunk->mesh_vertex_capacity = 0;
+    chunk->mesh_indices = NULL;
+    chunk->mesh_index_count = 0;
+    chunk->mesh_index_capacity = 0;
+    memset(chunk->mesh_index_counts, 0, sizeof(chunk->mesh_index_counts));
+    chunk->edits = NULL;
+    chunk->edit_count = 0;
+    chunk->edit_capacity = 0;
+    chunk->dirty = false;
+    chunk->render_dirty = true;
+    
+    /* Everything starts as air; sections allocate on their first differing write */
+    for (int i = 0; i < CHUNK_SECTION_COUNT; ++i) {
+        chunk->sections[i] = (ChunkSection){.data = NULL, .bits = 0, .palette_count = 1, .palette = {BLOCK_AIR}};
+    }
+}
+
+/* Slot tables are kept per section and built on the first edit inside it, so
+ * their memory follows the sections edited rather than the world height */
+#define SECTION_FACE_SLOTS ((size_t)CHUNK_SECTION_VOXELS * FACE_COUNT)
+
+static void chunk_free_face_slots(Chunk *chunk) {
+    for (int i = 0; i < CHUNK_SECTION_COUNT; ++i) {
+        arena_free(chunk->face_slots[i], SECTION_FACE_SLOTS * sizeof(uint32_t));
+        chunk->face_slots[i] = NULL;
+    }
+}
+
+static void chunk_destroy(Chunk *chunk) {
+    if (!chunk) return;
+    sections_free(chunk->sections);
+    arena_free(chunk->blocks, (size_t)chunk->block_capacity * sizeof(Block));
+    chunk_free_face_slots(chunk);
+    arena_free(chunk->mesh_vertices, (size_t)chunk->mesh_vertex_capacity * sizeof(MeshVertex));
+    arena_free(chunk->mesh_indices, (size_t)chunk->mesh_index_capacity * sizeof(uint32_t));
+    arena_free(chunk->edits, (size_t)chunk->edit_capacity * sizeof(ChunkEdit));
+    arena_free(chunk, sizeof(Chunk));
+}
+
+static inline bool chunk_in_bounds(int lx, int ly, int lz) {
+    return lx >= 0 && lx < CHUNK_SIZE &&
+           lz >= 0 && lz < CHUNK_SIZE &&
+           ly >= 0 && ly < CHUNK_HEIGHT;
+}
+
+static inline const ChunkSection *chunk_section(const Chunk *chunk, int ly) {
+    return &chunk->sections[ly / CHUNK_SECTION_HEIGHT];
+}
+
+static inline bool chunk_section_is_air(const ChunkSection *section) {
+    return section->bits == 0 && is_air(section->palette[0]);
+}
+
+static BlockId chunk_get_voxel(const Chunk *chunk, int lx, int ly, int lz) {
+    if (!chunk_in_bounds(lx, ly, lz)) return BLOCK_AIR;
+    
+    return section_get(chunk_section(chunk, ly), section_voxel_index(lx, ly % CHUNK_SECTION_HEIGHT, lz));
+}
+
+static void chunk_set_voxel(Chunk *chunk, int lx, int ly, int lz, BlockId type) {
+    if (!chunk_in_bounds(lx, ly, lz)) return;
+    
+    section_set(&chunk->sections[ly / CHUNK_SECTION_HEIGHT],
+                section_voxel_index(lx, ly % CHUNK_SECTION_HEIGHT, lz), type);
+}
+
+/* Voxels of one row along x; packed and uniform rows are decoded into `scratch` */
+static inline const BlockId *chunk_row(const Chunk *chunk, int ly, int lz,
+                                       BlockId scratch[CHUNK_SIZE]) {
+    const ChunkSection *section = chunk_section(chunk, ly);
+    size_t start = section_voxel_index(0, ly % CHUNK_SECTION_HEIGHT, lz);
+    if (section->bits == SECTION_RAW_BITS) return &section_raw(section)[start];
+    
+    section_decode_row(section, start, scratch);
+    return scratch;
+}
+
+static IVec3 chunk_local_to_world(const Chunk *chunk, int lx, int ly, int lz) {
+    return (IVec3){
+        chunk_to_base(chunk->cx) + lx,
+        WORLD_MIN_Y + ly,
+        chunk_to_base(chunk->cz) + lz
     };
+}
+
+static bool chunk_world_to_local(const Chunk *chunk, IVec3 pos, int *lx, int *ly, int *lz) {
+    if (!world_y_in_bounds(pos.y)) return false;
+    
+    *lx = pos.x - chunk_to_base(chunk->cx);
+    *lz = pos.z - chunk_to_base(chunk->cz);
+    *ly = pos.y - WORLD_MIN_Y;
+    
+    return chunk_in_bounds(*lx, *ly, *lz);
+}
+
+static void chunk_generate(Chunk *chunk);
+static Chunk *world_find_chunk(World *world, int cx, int cz);
+static Chunk *world_lookup_chunk(World *world, int cx, int cz);
+
+/* Face visibility works on per-row occupancy bitmasks. Each (y, z) row of a
+ * chunk is one word with bit lx + 1 set for voxel lx; bits 0 and CHUNK_SIZE + 1
+ * hold the neighboring chunks' edge voxels, and the grid carries one row of
+ * padding on every side so all six neighbors of a row are plain word lookups. */
+_Static_assert(CHUNK_SIZE + 2 <= 32, "Padded chunk rows must fit in 32 bits");
+
+#define ROW_INTERIOR_MASK (((1u << CHUNK_SIZE) - 1u) << 1)
+
+/* Rows [y0, y1) covering every section that holds more than air. Faces only
+ * come from non-air voxels, so a rebuild never looks outside this span and its
+ * cost follows the occupied sections, not CHUNK_HEIGHT. */
+typedef struct {
+    int y0;
+    int y1;
+} ChunkRowSpan;
+
+static ChunkRowSpan chunk_occupied_rows(const Chunk *chunk) {
+    int lo = 0, hi = CHUNK_SECTION_COUNT;
+    while (lo < hi && chunk_section_is_air(&chunk->sections[lo])) ++lo;
+    while (hi > lo && chunk_section_is_air(&chunk->sections[hi - 1])) --hi;
+    if (lo == hi) return (ChunkRowSpan){0, 0};
+    
+    int y1 = hi * CHUNK_SECTION_HEIGHT;
+    return (ChunkRowSpan){lo * CHUNK_SECTION_HEIGHT, y1 < CHUNK_HEIGHT ? y1 : CHUNK_HEIGHT};
+}
+
+typedef struct {
+    uint32_t opaque[CHUNK_HEIGHT + 2][CHUNK_SIZE + 2];
+    uint32_t liquid[CHUNK_HEIGHT + 2][CHUNK_SIZE + 2];
+} ChunkRowMasks;
+
+/* Opaque and liquid occupancy of one row, bit lx set for voxel lx */
+static inline void chunk_row_bits(const Chunk *chunk, int ly, int lz,
+                                  uint32_t *opaque_out, uint32_t *liquid_out) {
+    const ChunkSection *section = chunk_section(chunk, ly);
+    if (section->bits == 0) {
+        const uint32_t full = (1u << CHUNK_SIZE) - 1u;
+        unsigned flags = BLOCK_REGISTRY[section->palette[0]].flags;
+        *opaque_out = (flags & BLOCK_FLAG_OPAQUE) ? full : 0u;
+        *liquid_out = (flags & BLOCK_FLAG_LIQUID) ? full : 0u;
+        return;
+    }
+    
+    BlockId scratch[CHUNK_SIZE];
+    const BlockId *row = chunk_row(chunk, ly, lz, scratch);
+    uint32_t opaque = 0, liquid = 0;
+    
+    for (int lx = 0; lx < CHUNK_SIZE; ++lx) {
+        unsigned flags = BLOCK_REGISTRY[row[lx]].flags;
+        opaque |= (uint32_t)((flags & BLOCK_FLAG_OPAQUE) != 0) << lx;
+        liquid |= (uint32_t)((flags & BLOCK_FLAG_LIQUID) != 0) << lx;
+    }
+    
+    *opaque_out = opaque;
+    *liquid_out = liquid;
+}
+
+/* Packed rows are classified in place: a row of indices is one word, and
+ * comparing every field against the palette indices of see-through and liquid
+ * types at once gives the occupancy masks without decoding block types */
+_Static_assert(CHUNK_SIZE * 4 <= 64, "Packed 4-bit rows must fit in 64 bits");
+_Static_assert(CHUNK_SECTION_PALETTE_MAX <= 16, "Palette class masks are 16 bits");
+
+/* Palette indices, as bitmasks, of types that are neither opaque nor liquid
+ * (air) and of liquids; everything else in the palette is opaque */
+typedef struct {
+    uint16_t clear;
+    uint16_t liquid;
+} SectionClassMasks;
+
+static SectionClassMasks section_class_masks(const ChunkSection *section) {
+    SectionClassMasks masks = {0, 0};
+    for (int i = 0; i < section->palette_count; ++i) {
+        unsigned flags = BLOCK_REGISTRY[section->palette[i]].flags;
+        if (flags & BLOCK_FLAG_LIQUID) masks.liquid |= (uint16_t)(1u << i);
+        else if (!(flags & BLOCK_FLAG_OPAQUE)) masks.clear |= (uint16_t)(1u << i);
+    }
+    return masks;
+}
+
+/* Bit x set where the bits-wide field x of `row` equals `value` */
+static inline uint32_t row_fields_equal(uint64_t row, unsigned bits, unsigned value) {
+    const uint64_t low = bits == 1 ? ~0ull : bits == 2 ? 0x5555555555555555ull : 0x1111111111111111ull;
+    
+    uint64_t diff = row ^ (low * value);
+    uint64_t any = diff;
+    for (unsigned k = 1; k < bits; ++k) any |= diff >> k;
+    uint64_t v = ~any & low;
+    
+    /* Gather the low bit of each field into consecutive bits */
+    if (bits == 2) {
+        v = (v | (v >> 1)) & 0x3333333333333333ull;
+        v = (v | (v >> 2)) & 0x0F0F0F0F0F0F0F0Full;
+        v = (v | (v >> 4)) & 0x00FF00FF00FF00FFull;
+        v = (v | (v >> 8)) & 0x0000FFFF0000FFFFull;
+    } else if (bits == 4) {
+        v = (v | (v >> 3)) & 0x0303030303030303ull;
+        v = (v | (v >> 6)) & 0x000F000F000F000Full;
+        v = (v | (v >> 12)) & 0x000000FF000000FFull;
+        v = (v | (v >> 24)) & 0x000000000000FFFFull;
+    }
+    return (uint32_t)v & ((1u << CHUNK_SIZE) - 1u);
+}
+
+/* Fields of `row` holding any palette index in `indices`; sections rarely have
+ * more than one air or liquid entry, so the first compare is kept out of the loop */
+static inline uint32_t row_fields_in(uint64_t row, unsigned bits, unsigned indices) {
+    if (!indices) return 0u;
+    
+    uint32_t match = row_fields_equal(row, bits, (unsigned)__builtin_ctz(indices));
+    for (indices &= indices - 1; indices; indices &= indices - 1) {
+        match |= row_fields_equal(row, bits, (unsigned)__builtin_ctz(indices));
+    }
+    return match;
+}
+
+static inline void section_row_bits(const ChunkSection *section, unsigned bits,
+                                    SectionClassMasks classes, int sy, int lz,
+                                    uint32_t *opaque_out, uint32_t *liquid_out) {
+    const uint8_t *in = &section->data[section_voxel_index(0, sy, lz) * bits / 8u];
+    uint64_t row = 0;
+    for (unsigned j = 0; j < CHUNK_SIZE * bits / 8u; ++j) row |= (uint64_t)in[j] << (8u * j);
+    
+    uint32_t clear = row_fields_in(row, bits, classes.clear);
+    uint32_t liquid = row_fields_in(row, bits, classes.liquid);
+    
+    *liquid_out = liquid;
+    *opaque_out = ~(clear | liquid) & ((1u << CHUNK_SIZE) - 1u);
+}
+
+static inline void chunk_voxel_bits(const Chunk *chunk, int lx, int ly, int lz,
+                                    uint32_t *opaque_out, uint32_t *liquid_out) {
+    BlockId type = section_get(chunk_section(chunk, ly),
+                               section_voxel_index(lx, ly % CHUNK_SECTION_HEIGHT, lz));
+    unsigned flags = BLOCK_REGISTRY[type].flags;
+    *opaque_out = (flags & BLOCK_FLAG_OPAQUE) != 0;
+    *liquid_out = (flags & BLOCK_FLAG_LIQUID) != 0;
+}
+
+/* Fills padded rows occupied.y0 through occupied.y1 + 1; rows just below and
+ * above the span belong to this chunk's air sections and stay empty */
+static void chunk_build_row_masks(const Chunk *chunk, ChunkRowSpan occupied, ChunkRowMasks *m) {
+    /* Rows outside the world or in unloaded chunks stay empty, i.e. air */
+    size_t rows = (size_t)(occupied.y1 - occupied.y0 + 2);
+    memset(m->opaque[occupied.y0], 0, rows * sizeof(m->opaque[0]));
+    memset(m->liquid[occupied.y0], 0, rows * sizeof(m->liquid[0]));
+    
+    const Chunk *west = chunk->neighbors[CHUNK_NEIGHBOR_WEST];
+    const Chunk *east = chunk->neighbors[CHUNK_NEIGHBOR_EAST];
+    const Chunk *north = chunk->neighbors[CHUNK_NEIGHBOR_NORTH];
+    const Chunk *south = chunk->neighbors[CHUNK_NEIGHBOR_SOUTH];
     
-    for (int ly = 0; ly < CHUNK_HEIGHT; ++ly) {
+    SectionClassMasks classes[CHUNK_SECTION_COUNT];
+    for (int i = 0; i < CHUNK_SECTION_COUNT; ++i) {
+        classes[i] = section_class_masks(&chunk->sections[i]);
+    }
+    
+    for (int ly = occupied.y0; ly < occupied.y1; ++ly) {
+        uint32_t *opaque = m->opaque[ly + 1];
+        uint32_t *liquid = m->liquid[ly + 1];
+        uint32_t o, l;
+        
+        const ChunkSection *section = chunk_section(chunk, ly);
+        SectionClassMasks section_classes = classes[ly / CHUNK_SECTION_HEIGHT];
+        int sy = ly % CHUNK_SECTION_HEIGHT;
+        
         for (int lz = 0; lz < CHUNK_SIZE; ++lz) {
-            for (int lx = 0; lx < CHUNK_SIZE; ++lx) {
-                uint8_t type = chunk_get_voxel(chunk, lx, ly, lz);
-                if (is_air(type)) continue;
+            /* Constant widths let the field arithmetic fold */
+            switch (section->bits) {
+            case 1: section_row_bits(section, 1, section_classes, sy, lz, &o, &l); break;
+            case 2: section_row_bits(section, 2, section_classes, sy, lz, &o, &l); break;
+            case 4: section_row_bits(section, 4, section_classes, sy, lz, &o, &l); break;
+            default: chunk_row_bits(chunk, ly, lz, &o, &l); break;
+            }
+            opaque[lz + 1] = o << 1;
+            liquid[lz + 1] = l << 1;
+            
+            if (west) {
+                chunk_voxel_bits(west, CHUNK_SIZE - 1, ly, lz, &o, &l);
+                opaque[lz + 1] |= o;
+                liquid[lz + 1] |= l;
+            }
+            if (east) {
+                chunk_voxel_bits(east, 0, ly, lz, &o, &l);
+                opaque[lz + 1] |= o << (CHUNK_SIZE + 1);
+                liquid[lz + 1] |= l << (CHUNK_SIZE + 1);
+            }
+        }
+        
+        if (north) {
+            chunk_row_bits(north, ly, CHUNK_SIZE - 1, &o, &l);
+            opaque[0] = o << 1;
+            liquid[0] = l << 1;
+        }
+        if (south) {
+            chunk_row_bits(south, ly, 0, &o, &l);
+            opaque[CHUNK_SIZE + 1] = o << 1;
+            liquid[CHUNK_SIZE + 1] = l << 1;
+        }
+    }
+}
+
+/* Per-direction exposed faces of a row: a face shows where the neighbor across
+ * it is outside the voxel's class, i.e. opaque blocks facing air or liquid and
+ * liquids facing anything but liquid */
+static inline void row_exposed_faces(uint32_t (*rows)[CHUNK_SIZE + 2], int y, int z,
+                                     uint32_t faces[FACE_COUNT]) {
+    uint32_t center = rows[y][z] & ROW_INTERIOR_MASK;
+    faces[FACE_POS_Z] |= center & ~rows[y][z + 1];
+    faces[FACE_NEG_Z] |= center & ~rows[y][z - 1];
+    faces[FACE_POS_Y] |= center & ~rows[y + 1][z];
+    faces[FACE_NEG_Y] |= center & ~rows[y - 1][z];
+    faces[FACE_POS_X] |= center & ~(rows[y][z] >> 1);
+    faces[FACE_NEG_X] |= center & ~(rows[y][z] << 1);
+}
+
+/* Exposed faces per direction, bit lx of each (y, z) row */
+typedef uint16_t ChunkFaceMasks[FACE_COUNT][CHUNK_HEIGHT][CHUNK_SIZE];
+
+/* Block types of the (y, z) rows that have exposed faces, decoded once per
+ * rebuild; other rows are left uninitialized */
+typedef BlockId ChunkRowTypes[CHUNK_HEIGHT][CHUNK_SIZE][CHUNK_SIZE];
+
+static void chunk_emit_faces(Chunk *chunk, ChunkFaceMasks exposed, ChunkRowTypes types,
+                             ChunkRowSpan occupied, int face_total) {
+    chunk->block_count = 0;
+    chunk_ensure_capacity(chunk, face_total);
+    
+    /* Write cursor in locals: the scratch masks live on the heap, so stores
+     * through chunk would otherwise force them to be reloaded per face */
+    Block *blocks = chunk->blocks;
+    int count = 0;
+    
+    for (int f = 0; f < FACE_COUNT; ++f) {
+        int start = count;
+        
+        for (int ly = occupied.y0; ly < occupied.y1; ++ly) {
+            for (int lz = 0; lz < CHUNK_SIZE; ++lz) {
+                for (uint32_t bits = exposed[f][ly][lz]; bits; bits &= bits - 1) {
+                    int lx = __builtin_ctz(bits);
+                    blocks[count++] = (Block){
+                        .pos = chunk_local_to_world(chunk, lx, ly, lz),
+                        .type = types[ly][lz][lx],
+                        .face = (uint8_t)f
+                    };
+                }
+            }
+        }
+        
+        chunk->face_counts[f] = count - start;
+    }
+    chunk->block_count = count;
+}
+
+/* -------------------------------------------------------------------------- */
+/* Greedy Meshing                                                             */
+/* -------------------------------------------------------------------------- */
+
+typedef struct {
+    uint8_t normal_axis;
+    uint8_t u_axis;         /* Grid columns, always CHUNK_SIZE long */
+    uint8_t v_axis;         /* Grid rows */
+    uint8_t uv_axes[2];     /* Axes the texture u and v run along */
+    int8_t corners[4][3];   /* Corner signs, in (0, 1, 2) (2, 3, 0) winding */
+    uint8_t uvs[4][2];
+} FaceMeshLayout;
+
+/* Mirrors BLOCK_VERTICES and BLOCK_INDICES in renderer.c, so a 1x1 quad looks
+ * exactly like an instanced face and larger quads tile the same texture */
+static const FaceMeshLayout FACE_LAYOUTS[FACE_COUNT] = {
+    [FACE_POS_Z] = {2, 0, 1, {0, 1}, {{-1, -1,  1}, { 1, -1,  1}, { 1,  1,  1}, {-1,  1,  1}},
+                    {{0, 0}, {1, 0}, {1, 1}, {0, 1}}},
+    [FACE_NEG_Z] = {2, 0, 1, {0, 1}, {{ 1,  1, -1}, { 1, -1, -1}, {-1, -1, -1}, {-1,  1, -1}},
+                    {{0, 1}, {0, 0}, {1, 0}, {1, 1}}},
+    [FACE_POS_Y] = {1, 0, 2, {0, 2}, {{-1,  1, -1}, {-1,  1,  1}, { 1,  1,  1}, { 1,  1, -1}},
+                    {{0, 0}, {0, 1}, {1, 1}, {1, 0}}},
+    [FACE_NEG_Y] = {1, 0, 2, {0, 2}, {{-1, -1, -1}, { 1, -1, -1}, { 1, -1,  1}, {-1, -1,  1}},
+                    {{0, 1}, {1, 1}, {1, 0}, {0, 0}}},
+    [FACE_POS_X] = {0, 2, 1, {1, 2}, {{ 1, -1, -1}, { 1,  1, -1}, { 1,  1,  1}, { 1, -1,  1}},
+                    {{0, 0}, {1, 0}, {1, 1}, {0, 1}}},
+    [FACE_NEG_X] = {0, 2, 1, {1, 2}, {{-1,  1,  1}, {-1,  1, -1}, {-1, -1, -1}, {-1, -1,  1}},
+                    {{0, 1}, {0, 0}, {1, 0}, {1, 1}}},
+};
+
+static void chunk_ensure_mesh_capacity(Chunk *chunk, int vertex_count, int index_count) {
+    if (chunk->mesh_vertex_capacity < vertex_count) {
+        int new_cap = chunk->mesh_vertex_capacity > 0 ? chunk->mesh_vertex_capacity : 256;
+        while (new_cap < vertex_count) new_cap *= 2;
+        MeshVertex *new_vertices = arena_realloc(chunk->mesh_vertices,
+                                                 (size_t)chunk->mesh_vertex_capacity * sizeof(MeshVertex),
+                                                 (size_t)new_cap * sizeof(MeshVertex));
+        if (!new_vertices) die("Failed to allocate chunk mesh vertices");
+        chunk->mesh_vertices = new_vertices;
+        chunk->mesh_vertex_capacity = new_cap;
+    }
+    
+    if (chunk->mesh_index_capacity < index_count) {
+        int new_cap = chunk->mesh_index_capacity > 0 ? chunk->mesh_index_capacity : 384;
+        while (new_cap < index_count) new_cap *= 2;
+        uint32_t *new_indices = arena_realloc(chunk->mesh_indices,
+                                              (size_t)chunk->mesh_index_capacity * sizeof(uint32_t),
+                                              (size_t)new_cap * sizeof(uint32_t));
+        if (!new_indices) die("Failed to allocate chunk mesh indices");
+        chunk->mesh_indices = new_indices;
+        chunk->mesh_index_capacity = new_cap;
+    }
+}
+
+/* Appends the four corners of a w x h quad whose first cell is `cell` */
+static void chunk_emit_quad(Chunk *chunk, const FaceMeshLayout *layout, const int cell[3],
+                            int w, int h) {
+    const float base[3] = {
+        (float)chunk_to_base(chunk->cx), (float)WORLD_MIN_Y, (float)chunk_to_base(chunk->cz)
+    };
+    int extent[3] = {1, 1, 1};
+    extent[layout->u_axis] = w;
+    extent[layout->v_axis] = h;
+    
+    chunk_ensure_mesh_capacity(chunk, chunk->mesh_vertex_count + 4, 0);
+    
+    for (int k = 0; k < 4; ++k) {
+        float pos[3];
+        for (int a = 0; a < 3; ++a) {
+            float offset = layout->corners[k][a] < 0 ? -0.5f : (float)extent[a] - 0.5f;
+            pos[a] = base[a] + (float)cell[a] + offset;
+        }
+        
+        chunk->mesh_vertices[chunk->mesh_vertex_count++] = (MeshVertex){
+            .pos = vec3(pos[0], pos[1], pos[2]),
+            .uv = {(float)(layout->uvs[k][0] * extent[layout->uv_axes[0]]),
+                   (float)(layout->uvs[k][1] * extent[layout->uv_axes[1]])}
+        };
+    }
+}
+
+/* Merges each slice's exposed faces into maximal rectangles of one block type:
+ * grow along u while the type matches, then along v while whole rows do */
+static void chunk_build_greedy_mesh(Chunk *chunk, ChunkFaceMasks exposed, ChunkRowTypes types,
+                                    ChunkRowSpan occupied, int face_total) {
+    chunk->mesh_vertex_count = 0;
+    chunk->mesh_index_count = 0;
+    memset(chunk->mesh_index_counts, 0, sizeof(chunk->mesh_index_counts));
+    if (face_total == 0) return;
+    
+    /* At most one quad per face; remembered to group indices by texture below */
+    uint8_t *quad_textures = arena_alloc((size_t)face_total);
+    if (!quad_textures) die("Failed to allocate greedy mesh scratch");
+    int quad_count = 0;
+    
+    /* Per slice: block type of each exposed face and a bitmask of faces not yet merged */
+    BlockId grid[CHUNK_HEIGHT][CHUNK_SIZE];
+    uint32_t pending[CHUNK_HEIGHT];
+    
+    /* Cells along each axis that can hold faces; y is limited to the occupied rows */
+    const int axis_start[3] = {0, occupied.y0, 0};
+    const int axis_end[3] = {CHUNK_SIZE, occupied.y1, CHUNK_SIZE};
+    
+    for (int f = 0; f < FACE_COUNT; ++f) {
+        const FaceMeshLayout *layout = &FACE_LAYOUTS[f];
+        int u_size = CHUNK_SIZE;
+        int v_start = axis_start[layout->v_axis];
+        int v_end = axis_end[layout->v_axis];
+        
+        for (int slice = axis_start[layout->normal_axis]; slice < axis_end[layout->normal_axis]; ++slice) {
+            int cell[3];
+            cell[layout->normal_axis] = slice;
+            
+            uint32_t any = 0;
+            for (int v = v_start; v < v_end; ++v) {
+                cell[layout->v_axis] = v;
+                uint32_t bits = 0;
                 
-                IVec3 pos = chunk_local_to_world(chunk, lx, ly, lz);
+                if (layout->u_axis == 0) {
+                    /* Rows run along x, exactly like the face masks */
+                    bits = exposed[f][cell[1]][cell[2]];
+                    const BlockId *row = types[cell[1]][cell[2]];
+                    for (uint32_t b = bits; b; b &= b - 1) {
+                        int u = __builtin_ctz(b);
+                        grid[v][u] = row[u];
+                    }
+                } else {
+                    for (int u = 0; u < u_size; ++u) {
+                        cell[layout->u_axis] = u;
+                        if ((exposed[f][cell[1]][cell[2]] >> cell[0]) & 1u) {
+                            bits |= 1u << u;
+                            grid[v][u] = types[cell[1]][cell[2]][cell[0]];
+                        }
+                    }
+                }
                 
-                /* Check if any face is exposed */
-                bool visible = false;
-                for (int d = 0; d < 6; ++d) {
-                    IVec3 npos = ivec3_add(pos, neighbors[d]);
+                pending[v] = bits;
+                any |= bits;
+            }
+            if (!any) continue;
+            
+            for (int v = v_start; v < v_end; ++v) {
+                while (pending[v]) {
+                    int u = __builtin_ctz(pending[v]);
+                    BlockId type = grid[v][u];
                     
-                    uint8_t ntype = 255;
-                    if (world_y_in_bounds(npos.y)) {
-                        /* Same chunk or cross-chunk */
-                        int nlx = npos.x - base_x;
-                        int nlz = npos.z - base_z;
-                        int nly = npos.y - WORLD_MIN_Y;
-                        
-                        if (chunk_in_bounds(nlx, nly, nlz)) {
-                            ntype = chunk_get_voxel(chunk, nlx, nly, nlz);
-                        } else {
-                            world_get_block_type(world, npos, &ntype);
-                        }
+                    int w = 1;
+                    while (u + w < u_size && ((pending[v] >> (u + w)) & 1u) &&
+                           grid[v][u + w] == type) {
+                        ++w;
                     }
+                    uint32_t span = ((1u << w) - 1u) << u;
                     
-                    /* Water blocks are visible next to air or non-water */
-                    /* Solid blocks are visible next to air or water */
-                    if (is_water(type)) {
-                        if (is_air(ntype) || !is_water(ntype)) {
-                            visible = true;
-                            break;
-                        }
-                    } else {
-                        if (is_air(ntype) || is_water(ntype)) {
-                            visible = true;
-                            break;
-                        }
+                    int h = 1;
+                    for (; v + h < v_end && (pending[v + h] & span) == span; ++h) {
+                        int i = 0;
+                        while (i < w && grid[v + h][u + i] == type) ++i;
+                        if (i < w) break;
                     }
+                    
+                    for (int dv = 0; dv < h; ++dv) pending[v + dv] &= ~span;
+                    
+                    cell[layout->u_axis] = u;
+                    cell[layout->v_axis] = v;
+                    chunk_emit_quad(chunk, layout, cell, w, h);
+                    quad_textures[quad_count++] = block_texture(type);
                 }
+            }
+        }
+    }
+    
+    /* Counting sort of quads by texture so each texture is one index range */
+    int offsets[ITEM_TYPE_COUNT];
+    for (int q = 0; q < quad_count; ++q) chunk->mesh_index_counts[quad_textures[q]] += 6;
+    for (int t = 0, sum = 0; t < ITEM_TYPE_COUNT; ++t) {
+        offsets[t] = sum;
+        sum += chunk->mesh_index_counts[t];
+    }
+    
+    chunk->mesh_index_count = quad_count * 6;
+    chunk_ensure_mesh_capacity(chunk, 0, chunk->mesh_index_count);
+    
+    static const uint32_t QUAD_INDICES[6] = {0, 1, 2, 2, 3, 0};
+    for (int q = 0; q < quad_count; ++q) {
+        uint32_t *out = &chunk->mesh_indices[offsets[quad_textures[q]]];
+        for (int k = 0; k < 6; ++k) out[k] = (uint32_t)q * 4u + QUAD_INDICES[k];
+        offsets[quad_textures[q]] += 6;
+    }
+    
+    arena_free(quad_textures, (size_t)face_total);
+}
+
+/* Everything a rebuild works in, over 200 KB at the default height */
+typedef struct {
+    ChunkRowMasks masks;
+    ChunkFaceMasks exposed;
+    ChunkRowTypes types;
+} ChunkMeshScratch;
+
+static void chunk_rebuild_render_list(World *world, Chunk *chunk) {
+    ChunkMeshScratch *scratch = thread_scratch(SCRATCH_MESH, sizeof(ChunkMeshScratch));
+    ChunkRowSpan occupied = chunk_occupied_rows(chunk);
+    ChunkRowMasks *restrict masks = &scratch->masks;
+    chunk_build_row_masks(chunk, occupied, masks);
+    
+    uint16_t (*restrict exposed)[CHUNK_HEIGHT][CHUNK_SIZE] = scratch->exposed;
+    BlockId (*restrict types)[CHUNK_SIZE][CHUNK_SIZE] = scratch->types;
+    int face_total = 0;
+    
+    for (int s = occupied.y0 / CHUNK_SECTION_HEIGHT; s * CHUNK_SECTION_HEIGHT < occupied.y1; ++s) {
+        int y0 = s * CHUNK_SECTION_HEIGHT;
+        int y1 = y0 + CHUNK_SECTION_HEIGHT < CHUNK_HEIGHT ? y0 + CHUNK_SECTION_HEIGHT : CHUNK_HEIGHT;
+        
+        /* Air has no faces of its own, so empty sections are skipped wholesale */
+        if (chunk_section_is_air(&chunk->sections[s])) {
+            for (int f = 0; f < FACE_COUNT; ++f) {
+                memset(exposed[f][y0], 0, (size_t)(y1 - y0) * sizeof(exposed[f][y0]));
+            }
+            continue;
+        }
+        
+        for (int ly = y0; ly < y1; ++ly) {
+            for (int lz = 0; lz < CHUNK_SIZE; ++lz) {
+                uint32_t faces[FACE_COUNT] = {0};
+                row_exposed_faces(masks->opaque, ly + 1, lz + 1, faces);
+                row_exposed_faces(masks->liquid, ly + 1, lz + 1, faces);
                 
-                if (!visible) continue;
+                uint32_t any = 0;
+                for (int f = 0; f < FACE_COUNT; ++f) {
+                    exposed[f][ly][lz] = (uint16_t)(faces[f] >> 1);
+                    face_total += __builtin_popcount(faces[f]);
+                    any |= faces[f];
+                }
                 
-                chunk_ensure_capacity(chunk, chunk->block_count + 1);
-                chunk->blocks[chunk->block_count++] = (Block){.pos = pos, .type = type};
+                if (any) {
+                    section_decode_row(&chunk->sections[s],
+                                       section_voxel_index(0, ly - y0, lz), types[ly][lz]);
+                }
             }
         }
     }
     
-    chunk->render_dirty = false;
+    /* Slots index the old face list */
+    chunk_free_face_slots(chunk);
+    
+    /* Exactly one of the two representations is populated */
+    if (world->greedy_meshing) {
+        chunk->block_count = 0;
+        memset(chunk->face_counts, 0, sizeof(chunk->face_counts));
+        chunk_build_greedy_mesh(chunk, exposed, types, occupied, face_total);
+    } else {
+        chunk->mesh_vertex_count = 0;
+        chunk->mesh_index_count = 0;
+        memset(chunk->mesh_index_counts, 0, sizeof(chunk->mesh_index_counts));
+        chunk_emit_faces(chunk, exposed, types, occupied, face_total);
+    }
+    
+    chunk->state = CHUNK_STATE_MESHED;
+    chunk->render_dirty = false;
+}
+
+/* Drops a chunk's faces and mesh when it loses a neighbor: its border faces
+ * are no longer backed by loaded voxels, so it waits to be meshed again */
+static void chunk_discard_render_list(Chunk *chunk) {
+    chunk->state = CHUNK_STATE_GENERATED;
+    chunk->render_dirty = true;
+    
+    chunk->block_count = 0;
+    memset(chunk->face_counts, 0, sizeof(chunk->face_counts));
+    chunk_free_face_slots(chunk);
+    
+    chunk->mesh_vertex_count = 0;
+    chunk->mesh_index_count = 0;
+    memset(chunk->mesh_index_counts, 0, sizeof(chunk->mesh_index_counts));
+}
+
+/* Sets a voxel and notes it as an edit over the terrain; a voxel set back
+ * to its generated block is no longer an edit */
+static void chunk_edit_voxel(Chunk *chunk, int lx, int ly, int lz, BlockId type) {
+    uint32_t voxel = chunk_voxel_index(lx, ly, lz);
+    int i = edits_lower_bound(chunk->edits, chunk->edit_count, voxel);
+    
+    if (i < chunk->edit_count && chunk->edits[i].voxel == voxel) {
+        if (chunk->edits[i].generated == type) {
+            memmove(&chunk->edits[i], &chunk->edits[i + 1],
+                    (size_t)(chunk->edit_count - i - 1) * sizeof(ChunkEdit));
+            chunk->edit_count--;
+        } else {
+            chunk->edits[i].block = type;
+        }
+    } else {
+        chunk_reserve_edits(chunk, chunk->edit_count + 1);
+        memmove(&chunk->edits[i + 1], &chunk->edits[i], (size_t)(chunk->edit_count - i) * sizeof(ChunkEdit));
+        chunk->edits[i] = (ChunkEdit){
+            .voxel = voxel,
+            .block = type,
+            .generated = chunk_get_voxel(chunk, lx, ly, lz)
+        };
+        chunk->edit_count++;
+    }
+    
+    chunk_set_voxel(chunk, lx, ly, lz, type);
+    chunk->dirty = true;
+}
+
+/* Replays loaded edits over freshly generated terrain. Edits the terrain
+ * already matches are dropped, and the chunk is stored again without them. */
+static void chunk_apply_edits(Chunk *chunk) {
+    bool touched[CHUNK_SECTION_COUNT] = {false};
+    int kept = 0;
+    
+    for (int i = 0; i < chunk->edit_count; ++i) {
+        ChunkEdit edit = chunk->edits[i];
+        int lx = (int)(edit.voxel % CHUNK_SIZE);
+        int lz = (int)(edit.voxel / CHUNK_SIZE % CHUNK_SIZE);
+        int ly = (int)(edit.voxel / (CHUNK_SIZE * CHUNK_SIZE));
+        
+        edit.generated = chunk_get_voxel(chunk, lx, ly, lz);
+        if (edit.generated == edit.block) continue;
+        
+        chunk_set_voxel(chunk, lx, ly, lz, edit.block);
+        touched[ly / CHUNK_SECTION_HEIGHT] = true;
+        chunk->edits[kept++] = edit;
+    }
+    
+    if (kept != chunk->edit_count) chunk->dirty = true;
+    chunk->edit_count = kept;
+    
+    /* Edits can clear a type out of a section's palette */
+    for (int s = 0; s < CHUNK_SECTION_COUNT; ++s) {
+        if (touched[s]) section_compact(&chunk->sections[s]);
+    }
+}
+
+static bool chunk_add_block(Chunk *chunk, IVec3 pos, BlockId type) {
+    int lx, ly, lz;
+    if (!chunk_world_to_local(chunk, pos, &lx, &ly, &lz)) return false;
+    if (!is_air(chunk_get_voxel(chunk, lx, ly, lz))) return false;
+    
+    chunk_edit_voxel(chunk, lx, ly, lz, type);
+    return true;
+}
+
+static bool chunk_remove_block(Chunk *chunk, IVec3 pos) {
+    int lx, ly, lz;
+    if (!chunk_world_to_local(chunk, pos, &lx, &ly, &lz)) return false;
+    if (is_air(chunk_get_voxel(chunk, lx, ly, lz))) return false;
+    
+    chunk_edit_voxel(chunk, lx, ly, lz, BLOCK_AIR);
+    return true;
+}
+
+/* Terrain is never stored: it is generated again and the saved edits,
+ * if any, are replayed over it */
+static void chunk_load(WorldSave *save, Chunk *chunk) {
+    chunk_generate(chunk);
+    if (save_load_chunk(save, chunk)) chunk_apply_edits(chunk);
+}
+
+/* -------------------------------------------------------------------------- */
+/* Incremental Face Patching                                                  */
+/* -------------------------------------------------------------------------- */
+
+/* A single edit can only change the faces between the edited cell and its six
+ * neighbors, so edits patch the face list in place instead of rescanning the
+ * chunk. Direction groups stay contiguous: growing or shrinking one group moves
+ * at most one entry per later group. */
+
+#define FACE_SLOT_NONE UINT32_MAX
+
+_Static_assert((size_t)FACE_COUNT * CHUNK_SIZE * CHUNK_SIZE * CHUNK_HEIGHT < FACE_SLOT_NONE,
+               "Face slots must fit in 32 bits");
+
+static const IVec3 FACE_NORMALS[FACE_COUNT] = {
+    [FACE_POS_Z] = {0, 0, 1},  [FACE_NEG_Z] = {0, 0, -1},
+    [FACE_POS_Y] = {0, 1, 0},  [FACE_NEG_Y] = {0, -1, 0},
+    [FACE_POS_X] = {1, 0, 0},  [FACE_NEG_X] = {-1, 0, 0}
+};
+
+static inline int face_opposite(int face) {
+    return face ^ 1;
+}
+
+static inline int face_slot_section(IVec3 pos) {
+    return (pos.y - WORLD_MIN_Y) / CHUNK_SECTION_HEIGHT;
+}
+
+/* Slot of the face at pos, or NULL while its section has no table */
+static inline uint32_t *chunk_face_slot(const Chunk *chunk, IVec3 pos, int face) {
+    uint32_t *slots = chunk->face_slots[face_slot_section(pos)];
+    if (!slots) return NULL;
+    
+    int lx = pos.x - chunk_to_base(chunk->cx);
+    int lz = pos.z - chunk_to_base(chunk->cz);
+    int sy = (pos.y - WORLD_MIN_Y) % CHUNK_SECTION_HEIGHT;
+    return &slots[section_voxel_index(lx, sy, lz) * FACE_COUNT + (size_t)face];
+}
+
+/* Sections without a table are skipped; building one reads the current list */
+static inline void chunk_set_face_slot(Chunk *chunk, IVec3 pos, int face, uint32_t slot) {
+    uint32_t *entry = chunk_face_slot(chunk, pos, face);
+    if (entry) *entry = slot;
+}
+
+static void chunk_build_face_slots(Chunk *chunk, int section) {
+    if (chunk->face_slots[section]) return;
+    
+    chunk->face_slots[section] = arena_alloc(SECTION_FACE_SLOTS * sizeof(uint32_t));
+    if (!chunk->face_slots[section]) die("Failed to allocate chunk face slots");
+    memset(chunk->face_slots[section], 0xFF, SECTION_FACE_SLOTS * sizeof(uint32_t));
+    
+    for (int i = 0; i < chunk->block_count; ++i) {
+        const Block *b = &chunk->blocks[i];
+        if (face_slot_section(b->pos) == section) chunk_set_face_slot(chunk, b->pos, b->face, (uint32_t)i);
+    }
+}
+
+static inline int chunk_face_group_start(const Chunk *chunk, int face) {
+    int start = 0;
+    for (int f = 0; f < face; ++f) start += chunk->face_counts[f];
+    return start;
+}
+
+static void chunk_move_face(Chunk *chunk, int from, int to) {
+    if (from == to) return;
+    chunk->blocks[to] = chunk->blocks[from];
+    chunk_set_face_slot(chunk, chunk->blocks[to].pos, chunk->blocks[to].face, (uint32_t)to);
+}
+
+static void chunk_insert_face(Chunk *chunk, IVec3 pos, BlockId type, int face) {
+    chunk_ensure_capacity(chunk, chunk->block_count + 1);
+    
+    /* Open a hole at the end of the list, then walk it back to the end of the
+     * face's group by moving each later group's first entry to its end */
+    int hole = chunk->block_count;
+    for (int f = FACE_COUNT - 1; f > face; --f) {
+        int start = hole - chunk->face_counts[f];
+        chunk_move_face(chunk, start, hole);
+        hole = start;
+    }
+    
+    chunk->blocks[hole] = (Block){.pos = pos, .type = type, .face = (uint8_t)face};
+    chunk_set_face_slot(chunk, pos, face, (uint32_t)hole);
+    chunk->face_counts[face]++;
+    chunk->block_count++;
+}
+
+static void chunk_remove_face(Chunk *chunk, int slot) {
+    int face = chunk->blocks[slot].face;
+    chunk_set_face_slot(chunk, chunk->blocks[slot].pos, face, FACE_SLOT_NONE);
+    
+    /* Fill the slot from the end of its group, then pull the hole forward
+     * through the later groups */
+    int hole = chunk_face_group_start(chunk, face) + chunk->face_counts[face] - 1;
+    chunk_move_face(chunk, hole, slot);
+    for (int f = face + 1; f < FACE_COUNT; ++f) {
+        int last = hole + chunk->face_counts[f];
+        chunk_move_face(chunk, last, hole);
+        hole = last;
+    }
+    
+    chunk->face_counts[face]--;
+    chunk->block_count--;
+}
+
+/* Re-evaluates the face of the voxel at pos looking along `face` */
+static void world_patch_face(World *world, IVec3 pos, int face) {
+    if (!world_y_in_bounds(pos.y)) return;
+    
+    /* Chunks awaiting their first mesh or a full rebuild pick the change up anyway */
+    Chunk *chunk = world_lookup_chunk(world, cell_to_chunk(pos.x), cell_to_chunk(pos.z));
+    if (!chunk || chunk->state != CHUNK_STATE_MESHED || chunk->render_dirty) return;
+    
+    BlockId type = BLOCK_AIR, neighbor = BLOCK_AIR;
+    world_get_block_type(world, pos, &type);
+    world_get_block_type(world, ivec3_add(pos, FACE_NORMALS[face]), &neighbor);
+    unsigned face_class = block_face_class(type);
+    bool exposed = face_class != 0 && face_class != block_face_class(neighbor);
+    
+    chunk_build_face_slots(chunk, face_slot_section(pos));
+    uint32_t slot = *chunk_face_slot(chunk, pos, face);
+    if (slot == FACE_SLOT_NONE) {
+        if (exposed) chunk_insert_face(chunk, pos, type, face);
+    } else if (!exposed) {
+        chunk_remove_face(chunk, (int)slot);
+    } else {
+        chunk->blocks[slot].type = type;
+    }
+}
+
+static void world_patch_block_faces(World *world, IVec3 pos) {
+    for (int f = 0; f < FACE_COUNT; ++f) {
+        world_patch_face(world, pos, f);
+        world_patch_face(world, ivec3_add(pos, FACE_NORMALS[f]), face_opposite(f));
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+/* World Operations                                                           */
+/* -------------------------------------------------------------------------- */
+
+#define CHUNK_RETAIN_RADIUS (ACTIVE_CHUNK_RADIUS + CHUNK_UNLOAD_MARGIN)
+
+_Static_assert(CHUNK_LOAD_RADIUS <= CHUNK_RETAIN_RADIUS,
+               "Loaded chunks must lie inside the retained square");
+
+static void world_unload_chunk_at(World *world, int index);
+static void world_discard_pending_loads(World *world);
+
+#if WORLD_CHUNK_RING
+
+_Static_assert((CHUNK_RING_SIZE & (CHUNK_RING_SIZE - 1)) == 0,
+               "CHUNK_RING_SIZE must be a power of two");
+_Static_assert(CHUNK_RING_SIZE >= 2 * CHUNK_RETAIN_RADIUS + 1,
+               "CHUNK_RING_SIZE must cover the retained chunk square");
+
+#define CHUNK_INDEX_SLOTS (CHUNK_RING_SIZE * CHUNK_RING_SIZE)
+
+static inline uint32_t chunk_ring_slot(int cx, int cz) {
+    return ((uint32_t)cz & (CHUNK_RING_SIZE - 1u)) * CHUNK_RING_SIZE +
+           ((uint32_t)cx & (CHUNK_RING_SIZE - 1u));
+}
+
+static Chunk *world_find_chunk(World *world, int cx, int cz) {
+    Chunk *chunk = world->chunk_index[chunk_ring_slot(cx, cz)];
+    return (chunk && chunk->cx == cx && chunk->cz == cz) ? chunk : NULL;
+}
+
+static void world_index_insert(World *world, Chunk *chunk) {
+    uint32_t slot = chunk_ring_slot(chunk->cx, chunk->cz);
+    
+    /* A chunk left behind outside the ring window still owns the slot */
+    Chunk *stale = world->chunk_index[slot];
+    if (stale) world_unload_chunk_at(world, stale->list_index);
+    
+    world->chunk_index[slot] = chunk;
+}
+
+static void world_index_remove(World *world, const Chunk *chunk) {
+    uint32_t slot = chunk_ring_slot(chunk->cx, chunk->cz);
+    if (world->chunk_index[slot] == chunk) world->chunk_index[slot] = NULL;
+}
+
+#else
+
+_Static_assert((CHUNK_INDEX_CAPACITY & (CHUNK_INDEX_CAPACITY - 1)) == 0,
+               "CHUNK_INDEX_CAPACITY must be a power of two");
+_Static_assert(CHUNK_INDEX_CAPACITY >= 2 * MAX_LOADED_CHUNKS,
+               "CHUNK_INDEX_CAPACITY must be at least twice MAX_LOADED_CHUNKS");
+
+#define CHUNK_INDEX_SLOTS CHUNK_INDEX_CAPACITY
+
+static inline uint32_t chunk_index_hash(int cx, int cz) {
+    uint32_t h = (uint32_t)cx * 0x9E3779B1u ^ (uint32_t)cz * 0x85EBCA77u;
+    h ^= h >> 15;
+    h *= 0xC2B2AE3Du;
+    h ^= h >> 13;
+    return h & (CHUNK_INDEX_CAPACITY - 1u);
+}
+
+static Chunk *world_find_chunk(World *world, int cx, int cz) {
+    uint32_t slot = chunk_index_hash(cx, cz);
+    for (;;) {
+        Chunk *chunk = world->chunk_index[slot];
+        if (!chunk) return NULL;
+        if (chunk->cx == cx && chunk->cz == cz) return chunk;
+        slot = (slot + 1u) & (CHUNK_INDEX_CAPACITY - 1u);
+    }
+}
+
+static void world_index_insert(World *world, Chunk *chunk) {
+    uint32_t slot = chunk_index_hash(chunk->cx, chunk->cz);
+    while (world->chunk_index[slot]) {
+        slot = (slot + 1u) & (CHUNK_INDEX_CAPACITY - 1u);
+    }
+    world->chunk_index[slot] = chunk;
+}
+
+static void world_index_remove(World *world, const Chunk *chunk) {
+    const uint32_t mask = CHUNK_INDEX_CAPACITY - 1u;
+    
+    uint32_t slot = chunk_index_hash(chunk->cx, chunk->cz);
+    while (world->chunk_index[slot] != chunk) {
+        if (!world->chunk_index[slot]) return;
+        slot = (slot + 1u) & mask;
+    }
+    
+    /* Backward-shift deletion keeps probe runs contiguous without tombstones */
+    uint32_t hole = slot;
+    for (uint32_t next = (hole + 1u) & mask; world->chunk_index[next]; next = (next + 1u) & mask) {
+        Chunk *candidate = world->chunk_index[next];
+        uint32_t home = chunk_index_hash(candidate->cx, candidate->cz);
+        if (((next - home) & mask) >= ((next - hole) & mask)) {
+            world->chunk_index[hole] = candidate;
+            hole = next;
+        }
+    }
+    world->chunk_index[hole] = NULL;
 }
 
-static bool chunk_add_block(Chunk *chunk, IVec3 pos, uint8_t type) {
-    int lx, ly, lz;
-    if (!chunk_world_to_local(chunk, pos, &lx, &ly, &lz)) return false;
-    if (!is_air(chunk_get_voxel(chunk, lx, ly, lz))) return false;
+#endif /* WORLD_CHUNK_RING */
+
+static const int CHUNK_NEIGHBOR_OFFSETS[CHUNK_NEIGHBOR_COUNT][2] = {
+    [CHUNK_NEIGHBOR_WEST] = {-1, 0}, [CHUNK_NEIGHBOR_EAST] = {1, 0},
+    [CHUNK_NEIGHBOR_NORTH] = {0, -1}, [CHUNK_NEIGHBOR_SOUTH] = {0, 1}
+};
+
+static void chunk_update_readiness(Chunk *chunk) {
+    if (chunk->state != CHUNK_STATE_GENERATED) return;
     
-    chunk_set_voxel(chunk, lx, ly, lz, type);
-    chunk->dirty = true;
+    for (int d = 0; d < CHUNK_NEIGHBOR_COUNT; ++d) {
+        if (!chunk->neighbors[d]) return;
+    }
+    chunk->state = CHUNK_STATE_NEIGHBORS_READY;
     chunk->render_dirty = true;
-    return true;
 }
 
-static bool chunk_remove_block(Chunk *chunk, IVec3 pos) {
-    int lx, ly, lz;
-    if (!chunk_world_to_local(chunk, pos, &lx, &ly, &lz)) return false;
-    if (is_air(chunk_get_voxel(chunk, lx, ly, lz))) return false;
-    
-    chunk_set_voxel(chunk, lx, ly, lz, 255);
-    chunk->dirty = true;
-    chunk->render_dirty = true;
-    return true;
+/* A meshed chunk already has all four neighbors, so an arriving chunk only
+ * ever completes neighbors still waiting; each of those is meshed once */
+static void world_link_neighbors(World *world, Chunk *chunk) {
+    for (int d = 0; d < CHUNK_NEIGHBOR_COUNT; ++d) {
+        Chunk *neighbor = world_find_chunk(world, chunk->cx + CHUNK_NEIGHBOR_OFFSETS[d][0],
+                                           chunk->cz + CHUNK_NEIGHBOR_OFFSETS[d][1]);
+        chunk->neighbors[d] = neighbor;
+        if (neighbor) {
+            neighbor->neighbors[d ^ 1] = chunk;
+            chunk_update_readiness(neighbor);
+        }
+    }
+    chunk_update_readiness(chunk);
 }
 
-/* -------------------------------------------------------------------------- */
-/* World Operations                                                           */
-/* -------------------------------------------------------------------------- */
+static void world_unlink_neighbors(World *world, Chunk *chunk) {
+    for (int d = 0; d < CHUNK_NEIGHBOR_COUNT; ++d) {
+        Chunk *neighbor = chunk->neighbors[d];
+        if (!neighbor) continue;
+        neighbor->neighbors[d ^ 1] = NULL;
+        chunk_discard_render_list(neighbor);
+    }
+    if (world->lookup_hint == chunk) world->lookup_hint = NULL;
+}
 
-static Chunk *world_find_chunk(World *world, int cx, int cz) {
-    for (int i = 0; i < world->chunk_count; ++i) {
-        if (world->chunks[i]->cx == cx && world->chunks[i]->cz == cz) {
-            return world->chunks[i];
+/* Chunk lookup for block queries: nearby queries (physics, edits, border
+ * probes) mostly hit the same chunk or step to an adjacent one, which is a
+ * pointer hop from the previous hit instead of an index search */
+static Chunk *world_lookup_chunk(World *world, int cx, int cz) {
+    Chunk *hint = world->lookup_hint;
+    if (hint) {
+        int dx = cx - hint->cx;
+        int dz = cz - hint->cz;
+        if (dx == 0 && dz == 0) return hint;
+        
+        int d = -1;
+        if (dz == 0 && (dx == 1 || dx == -1)) d = dx < 0 ? CHUNK_NEIGHBOR_WEST : CHUNK_NEIGHBOR_EAST;
+        if (dx == 0 && (dz == 1 || dz == -1)) d = dz < 0 ? CHUNK_NEIGHBOR_NORTH : CHUNK_NEIGHBOR_SOUTH;
+        if (d >= 0) {
+            /* Links are exact: NULL means the neighbor is not loaded */
+            Chunk *neighbor = hint->neighbors[d];
+            if (neighbor) world->lookup_hint = neighbor;
+            return neighbor;
         }
     }
-    return NULL;
+    
+    Chunk *chunk = world_find_chunk(world, cx, cz);
+    if (chunk) world->lookup_hint = chunk;
+    return chunk;
 }
 
 static void world_add_chunk(World *world, Chunk *chunk) {
@@ -499,6 +2433,10 @@ static void world_add_chunk(World *world, Chunk *chunk) {
         world->chunk_capacity = new_cap;
     }
     
+    world_index_insert(world, chunk);
+    world_link_neighbors(world, chunk);
+    
+    chunk->list_index = world->chunk_count;
     world->chunks[world->chunk_count++] = chunk;
     
     if ((uint32_t)world->chunk_count > MAX_LOADED_CHUNKS) {
@@ -523,8 +2461,7 @@ static void world_try_set_spawn(World *world, Chunk *chunk) {
     
     /* Find highest solid block at spawn */
     for (int ly = CHUNK_HEIGHT - 1; ly >= 0; --ly) {
-        uint8_t type = chunk_get_voxel(chunk, lx, ly, lz);
-        if (!is_air(type) && !is_water(type)) {
+        if (block_is_solid(chunk_get_voxel(chunk, lx, ly, lz))) {
             world->spawn_position = vec3(0.0f, (float)(WORLD_MIN_Y + ly) + 0.5f, 0.0f);
             world->spawn_set = true;
             return;
@@ -533,17 +2470,11 @@ static void world_try_set_spawn(World *world, Chunk *chunk) {
 }
 
 static Chunk *world_create_chunk(World *world, int cx, int cz) {
-    Chunk *chunk = malloc(sizeof(Chunk));
+    Chunk *chunk = arena_alloc(sizeof(Chunk));
     if (!chunk) die("Failed to allocate chunk");
     
     chunk_init(chunk, cx, cz);
-    
-    bool loaded = save_load_chunk(world->save, cx, cz, chunk->voxels);
-    if (!loaded) {
-        chunk_generate(world, chunk);
-        chunk->dirty = true;
-    }
-    chunk->render_dirty = true;
+    chunk_load(world->save, chunk);
     
     world_try_set_spawn(world, chunk);
     world_add_chunk(world, chunk);
@@ -555,40 +2486,44 @@ static void world_unload_chunk_at(World *world, int index) {
     Chunk *chunk = world->chunks[index];
     
     if (chunk->dirty) {
-        save_store_chunk(world->save, chunk->cx, chunk->cz, chunk->voxels);
+        save_store_chunk(world->save, chunk);
     }
     
+    world_index_remove(world, chunk);
+    world_unlink_neighbors(world, chunk);
     chunk_destroy(chunk);
-    world->chunks[index] = world->chunks[--world->chunk_count];
+    
+    if (index != --world->chunk_count) {
+        world->chunks[index] = world->chunks[world->chunk_count];
+        world->chunks[index]->list_index = index;
+    }
 }
 
 static void world_mark_neighbors_dirty(World *world, IVec3 pos) {
-    int cx = cell_to_chunk(pos.x);
-    int cz = cell_to_chunk(pos.z);
-    
-    Chunk *center = world_find_chunk(world, cx, cz);
-    if (center) center->render_dirty = true;
+    Chunk *center = world_lookup_chunk(world, cell_to_chunk(pos.x), cell_to_chunk(pos.z));
+    if (!center) return;
+    center->render_dirty = true;
     
     /* Mark neighbors if on chunk boundary */
-    int base_x = chunk_to_base(cx);
-    int base_z = chunk_to_base(cz);
-    int lx = pos.x - base_x;
-    int lz = pos.z - base_z;
+    int lx = pos.x - chunk_to_base(center->cx);
+    int lz = pos.z - chunk_to_base(center->cz);
     
-    if (lx == 0) {
-        Chunk *c = world_find_chunk(world, cx - 1, cz);
-        if (c) c->render_dirty = true;
-    } else if (lx == CHUNK_SIZE - 1) {
-        Chunk *c = world_find_chunk(world, cx + 1, cz);
-        if (c) c->render_dirty = true;
-    }
+    Chunk *x_neighbor = NULL, *z_neighbor = NULL;
+    if (lx == 0) x_neighbor = center->neighbors[CHUNK_NEIGHBOR_WEST];
+    else if (lx == CHUNK_SIZE - 1) x_neighbor = center->neighbors[CHUNK_NEIGHBOR_EAST];
+    if (lz == 0) z_neighbor = center->neighbors[CHUNK_NEIGHBOR_NORTH];
+    else if (lz == CHUNK_SIZE - 1) z_neighbor = center->neighbors[CHUNK_NEIGHBOR_SOUTH];
     
-    if (lz == 0) {
-        Chunk *c = world_find_chunk(world, cx, cz - 1);
-        if (c) c->render_dirty = true;
-    } else if (lz == CHUNK_SIZE - 1) {
-        Chunk *c = world_find_chunk(world, cx, cz + 1);
-        if (c) c->render_dirty = true;
+    if (x_neighbor) x_neighbor->render_dirty = true;
+    if (z_neighbor) z_neighbor->render_dirty = true;
+}
+
+static void world_block_changed(World *world, IVec3 pos) {
+    /* Greedy quads span many cells, so meshes are rebuilt rather than patched */
+    if (world->greedy_meshing) {
+        world_mark_neighbors_dirty(world, pos);
+    } else {
+        world_patch_block_faces(world, pos);
     }
 }
 
@@ -596,48 +2531,81 @@ void world_init(World *world, WorldSave *save) {
     memset(world, 0, sizeof(*world));
     world->spawn_position = vec3(0.0f, 4.5f, 0.0f);
     world->save = save;
+    world->chunk_index = calloc(CHUNK_INDEX_SLOTS, sizeof(Chunk *));
+    if (!world->chunk_index) die("Failed to allocate chunk index");
+    world->jobs = job_pool_create(0);
+    atomic_init(&world->finished_loads, NULL);
+    world->stream_budget_ms = CHUNK_STREAM_BUDGET_MS;
+    world->greedy_meshing = WORLD_GREEDY_MESH;
     world->entities = NULL;
     world->entity_count = 0;
     world->entity_capacity = 0;
 }
 
+void world_save_edited_chunks(World *world) {
+    for (int i = 0; i < world->chunk_count; ++i) {
+        Chunk *chunk = world->chunks[i];
+        if (!chunk->dirty) continue;
+        save_store_chunk(world->save, chunk);
+        chunk->dirty = false;
+    }
+}
+
 void world_destroy(World *world) {
+    world_discard_pending_loads(world);
+    
     for (int i = 0; i < world->chunk_count; ++i) {
         Chunk *chunk = world->chunks[i];
         if (chunk->dirty) {
-            save_store_chunk(world->save, chunk->cx, chunk->cz, chunk->voxels);
+            save_store_chunk(world->save, chunk);
         }
         chunk_destroy(chunk);
     }
     free(world->chunks);
+    free(world->chunk_index);
+    free(world->load_queue);
+    free(world->rebuild_list);
     free(world->entities);
     memset(world, 0, sizeof(*world));
 }
 
-void world_update_chunks(World *world, Vec3 player_pos) {
-    IVec3 center_cell = world_to_cell(player_pos);
-    int center_cx = cell_to_chunk(center_cell.x);
-    int center_cz = cell_to_chunk(center_cell.z);
-    
-    /* Load chunks in view radius */
-    for (int dz = -ACTIVE_CHUNK_RADIUS; dz <= ACTIVE_CHUNK_RADIUS; ++dz) {
-        for (int dx = -ACTIVE_CHUNK_RADIUS; dx <= ACTIVE_CHUNK_RADIUS; ++dx) {
-            int cx = center_cx + dx;
-            int cz = center_cz + dz;
-            if (!world_find_chunk(world, cx, cz)) {
-                world_create_chunk(world, cx, cz);
-            }
+typedef void (*ChunkCoordFn)(World *world, int cx, int cz);
+
+/* Visits the chunk coordinates of the square of `radius` around (cx, cz) that lie
+ * outside the same-sized square around (other_cx, other_cz). Both centers must be
+ * within `radius` of each other on each axis. */
+static void for_each_square_difference(World *world, int cx, int cz, int other_cx, int other_cz,
+                                       int radius, ChunkCoordFn fn) {
+    for (int x = cx - radius; x <= cx + radius; ++x) {
+        if (abs(x - other_cx) > radius) {
+            for (int z = cz - radius; z <= cz + radius; ++z) fn(world, x, z);
+            continue;
         }
+        
+        /* Column overlaps the other square: only its ends stick out */
+        for (int z = cz - radius; z < other_cz - radius; ++z) fn(world, x, z);
+        for (int z = other_cz + radius + 1; z <= cz + radius; ++z) fn(world, x, z);
     }
-    
-    /* Unload distant chunks */
+}
+
+static void world_ensure_chunk(World *world, int cx, int cz) {
+    if (!world_find_chunk(world, cx, cz)) world_create_chunk(world, cx, cz);
+}
+
+#if WORLD_CHUNK_RING
+static void world_unload_chunk_coord(World *world, int cx, int cz) {
+    Chunk *chunk = world_find_chunk(world, cx, cz);
+    if (chunk) world_unload_chunk_at(world, chunk->list_index);
+}
+#endif
+
+static void world_unload_distant_chunks(World *world) {
     for (int i = 0; i < world->chunk_count; ) {
         Chunk *chunk = world->chunks[i];
-        int dx = abs(chunk->cx - center_cx);
-        int dz = abs(chunk->cz - center_cz);
+        int dx = abs(chunk->cx - world->center_cx);
+        int dz = abs(chunk->cz - world->center_cz);
         
-        if (dx > ACTIVE_CHUNK_RADIUS + CHUNK_UNLOAD_MARGIN ||
-            dz > ACTIVE_CHUNK_RADIUS + CHUNK_UNLOAD_MARGIN) {
+        if (dx > CHUNK_RETAIN_RADIUS || dz > CHUNK_RETAIN_RADIUS) {
             world_unload_chunk_at(world, i);
         } else {
             ++i;
@@ -645,6 +2613,308 @@ void world_update_chunks(World *world, Vec3 player_pos) {
     }
 }
 
+/* -------------------------------------------------------------------------- */
+/* Chunk Load Queue                                                           */
+/* -------------------------------------------------------------------------- */
+
+static inline bool world_load_queue_empty(const World *world) {
+    return world->load_queue_count == 0;
+}
+
+static inline bool chunk_in_load_square(const World *world, int cx, int cz) {
+    return abs(cx - world->center_cx) <= CHUNK_LOAD_RADIUS &&
+           abs(cz - world->center_cz) <= CHUNK_LOAD_RADIUS;
+}
+
+static uint32_t chunk_load_priority(const World *world, const Camera *camera, ChunkCoord coord) {
+    int dx = coord.cx - world->center_cx;
+    int dz = coord.cz - world->center_cz;
+    uint32_t dist_sq = (uint32_t)(dx * dx + dz * dz);
+    
+    if (!camera) return dist_sq;
+    
+    Vec3 min = vec3((float)chunk_to_base(coord.cx), (float)WORLD_MIN_Y,
+                    (float)chunk_to_base(coord.cz));
+    Vec3 max = vec3(min.x + CHUNK_SIZE, (float)(WORLD_MAX_Y + 1), min.z + CHUNK_SIZE);
+    if (camera_box_visible(camera, min, max)) return dist_sq;
+    
+    return dist_sq * CHUNK_OFFSCREEN_DISTANCE_SCALE * CHUNK_OFFSCREEN_DISTANCE_SCALE;
+}
+
+static void load_queue_sift_down(ChunkLoadRequest *heap, int count, int i) {
+    for (;;) {
+        int smallest = i;
+        int left = 2 * i + 1;
+        int right = left + 1;
+        
+        if (left < count && heap[left].priority < heap[smallest].priority) smallest = left;
+        if (right < count && heap[right].priority < heap[smallest].priority) smallest = right;
+        if (smallest == i) return;
+        
+        ChunkLoadRequest tmp = heap[i];
+        heap[i] = heap[smallest];
+        heap[smallest] = tmp;
+        i = smallest;
+    }
+}
+
+/* Appends without ordering; world_prioritize_load_queue restores the heap */
+static void world_queue_chunk_load(World *world, int cx, int cz) {
+    if (world_find_chunk(world, cx, cz)) return;
+    
+    if (world->load_queue_count >= world->load_queue_capacity) {
+        int new_cap = world->load_queue_capacity > 0 ? world->load_queue_capacity * 2 : 256;
+        ChunkLoadRequest *new_queue = realloc(world->load_queue,
+                                              (size_t)new_cap * sizeof(ChunkLoadRequest));
+        if (!new_queue) die("Failed to allocate chunk load queue");
+        world->load_queue = new_queue;
+        world->load_queue_capacity = new_cap;
+    }
+    
+    world->load_queue[world->load_queue_count++] = (ChunkLoadRequest){
+        .coord = {.cx = cx, .cz = cz},
+        .priority = 0
+    };
+}
+
+static void world_queue_load_square(World *world) {
+    world->load_queue_count = 0;
+    
+    for (int dz = -CHUNK_LOAD_RADIUS; dz <= CHUNK_LOAD_RADIUS; ++dz) {
+        for (int dx = -CHUNK_LOAD_RADIUS; dx <= CHUNK_LOAD_RADIUS; ++dx) {
+            world_queue_chunk_load(world, world->center_cx + dx, world->center_cz + dz);
+        }
+    }
+}
+
+/* Drops entries that scrolled out or were loaded meanwhile, re-scores the rest
+ * against the current center and view, and rebuilds the heap. Keeping the queue
+ * inside the loaded square also means newly entering strips never duplicate it. */
+static void world_prioritize_load_queue(World *world, const Camera *camera) {
+    int kept = 0;
+    for (int i = 0; i < world->load_queue_count; ++i) {
+        ChunkCoord coord = world->load_queue[i].coord;
+        if (!chunk_in_load_square(world, coord.cx, coord.cz) ||
+            world_find_chunk(world, coord.cx, coord.cz)) {
+            continue;
+        }
+        world->load_queue[kept++] = (ChunkLoadRequest){
+            .coord = coord,
+            .priority = chunk_load_priority(world, camera, coord)
+        };
+    }
+    world->load_queue_count = kept;
+    
+    for (int i = kept / 2 - 1; i >= 0; --i) {
+        load_queue_sift_down(world->load_queue, kept, i);
+    }
+}
+
+static ChunkCoord world_pop_chunk_load(World *world) {
+    ChunkCoord coord = world->load_queue[0].coord;
+    world->load_queue[0] = world->load_queue[--world->load_queue_count];
+    load_queue_sift_down(world->load_queue, world->load_queue_count, 0);
+    return coord;
+}
+
+/* -------------------------------------------------------------------------- */
+/* Chunk Streaming                                                            */
+/* -------------------------------------------------------------------------- */
+
+static void world_recenter(World *world, int center_cx, int center_cz) {
+    int old_cx = world->center_cx;
+    int old_cz = world->center_cz;
+    bool scroll = world->center_valid &&
+                  abs(center_cx - old_cx) <= CHUNK_LOAD_RADIUS &&
+                  abs(center_cz - old_cz) <= CHUNK_LOAD_RADIUS;
+    
+    world->center_cx = center_cx;
+    world->center_cz = center_cz;
+    world->center_valid = true;
+    
+    /* Unload first so a long jump never exceeds MAX_LOADED_CHUNKS */
+#if WORLD_CHUNK_RING
+    if (scroll) {
+        for_each_square_difference(world, old_cx, old_cz, center_cx, center_cz,
+                                   CHUNK_RETAIN_RADIUS, world_unload_chunk_coord);
+    } else {
+        world_unload_distant_chunks(world);
+    }
+#else
+    world_unload_distant_chunks(world);
+#endif
+    
+    /* Pending entries stay queued; only the rows and columns entering the square are new */
+    if (scroll) {
+        for_each_square_difference(world, center_cx, center_cz, old_cx, old_cz,
+                                   CHUNK_LOAD_RADIUS, world_queue_chunk_load);
+    } else {
+        world_queue_load_square(world);
+    }
+    
+    /* The player's chunk and its neighbors are never deferred */
+    for (int dz = -CHUNK_SYNC_RADIUS; dz <= CHUNK_SYNC_RADIUS; ++dz) {
+        for (int dx = -CHUNK_SYNC_RADIUS; dx <= CHUNK_SYNC_RADIUS; ++dx) {
+            world_ensure_chunk(world, center_cx + dx, center_cz + dz);
+        }
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+/* Background Chunk Loading                                                   */
+/* -------------------------------------------------------------------------- */
+
+struct ChunkLoadJob {
+    ChunkLoadJob *next;
+    World *world;
+    Chunk *chunk;
+};
+
+static void chunk_load_job_run(void *arg) {
+    ChunkLoadJob *job = arg;
+    World *world = job->world;
+    Chunk *chunk = job->chunk;
+    
+    chunk_load(world->save, chunk);
+    
+    /* Lock-free push onto the completion stack drained by the main thread */
+    ChunkLoadJob *head = atomic_load_explicit(&world->finished_loads, memory_order_relaxed);
+    do {
+        job->next = head;
+    } while (!atomic_compare_exchange_weak_explicit(&world->finished_loads, &head, job,
+                                                    memory_order_release, memory_order_relaxed));
+}
+
+static int world_find_in_flight(const World *world, int cx, int cz) {
+    for (int i = 0; i < world->in_flight_count; ++i) {
+        if (world->in_flight[i].cx == cx && world->in_flight[i].cz == cz) return i;
+    }
+    return -1;
+}
+
+static void world_submit_chunk_load(World *world, int cx, int cz) {
+    ChunkLoadJob *job = arena_alloc(sizeof(ChunkLoadJob));
+    Chunk *chunk = arena_alloc(sizeof(Chunk));
+    if (!job || !chunk) die("Failed to allocate chunk load job");
+    
+    chunk_init(chunk, cx, cz);
+    *job = (ChunkLoadJob){.next = NULL, .world = world, .chunk = chunk};
+    
+    world->in_flight[world->in_flight_count++] = (ChunkCoord){.cx = cx, .cz = cz};
+    job_pool_submit(world->jobs, chunk_load_job_run, job);
+}
+
+/* Hands the best pending chunk to a worker; false when nothing could be submitted */
+static bool world_submit_next_chunk_load(World *world) {
+    while (world->in_flight_count < CHUNK_MAX_IN_FLIGHT && !world_load_queue_empty(world)) {
+        ChunkCoord coord = world_pop_chunk_load(world);
+        
+        /* Synchronous loads may have claimed it since the queue was pruned */
+        if (world_find_chunk(world, coord.cx, coord.cz) ||
+            world_find_in_flight(world, coord.cx, coord.cz) >= 0) {
+            continue;
+        }
+        
+        world_submit_chunk_load(world, coord.cx, coord.cz);
+        return true;
+    }
+    return false;
+}
+
+static void world_collect_finished_loads(World *world) {
+    ChunkLoadJob *finished = atomic_exchange_explicit(&world->finished_loads, NULL,
+                                                      memory_order_acquire);
+    
+    /* The stack is newest first; append oldest first to keep completion order */
+    ChunkLoadJob *ordered = NULL;
+    while (finished) {
+        ChunkLoadJob *next = finished->next;
+        finished->next = ordered;
+        ordered = finished;
+        finished = next;
+    }
+    
+    ChunkLoadJob **tail = &world->ready_loads;
+    while (*tail) tail = &(*tail)->next;
+    *tail = ordered;
+}
+
+static void world_discard_pending_loads(World *world) {
+    /* Let outstanding loads finish, then drop them unintegrated */
+    job_pool_destroy(world->jobs);
+    world->jobs = NULL;
+    
+    world_collect_finished_loads(world);
+    while (world->ready_loads) {
+        ChunkLoadJob *job = world->ready_loads;
+        world->ready_loads = job->next;
+        chunk_destroy(job->chunk);
+        arena_free(job, sizeof(ChunkLoadJob));
+    }
+    world->in_flight_count = 0;
+}
+
+/* Adds one finished load to the world; false when none are ready */
+static bool world_integrate_finished_load(World *world) {
+    if (!world->ready_loads) world_collect_finished_loads(world);
+    
+    while (world->ready_loads) {
+        ChunkLoadJob *job = world->ready_loads;
+        world->ready_loads = job->next;
+        
+        Chunk *chunk = job->chunk;
+        arena_free(job, sizeof(ChunkLoadJob));
+        
+        int slot = world_find_in_flight(world, chunk->cx, chunk->cz);
+        if (slot >= 0) world->in_flight[slot] = world->in_flight[--world->in_flight_count];
+        
+        /* Drop results that were loaded synchronously meanwhile or left the window */
+        if (abs(chunk->cx - world->center_cx) > CHUNK_RETAIN_RADIUS ||
+            abs(chunk->cz - world->center_cz) > CHUNK_RETAIN_RADIUS ||
+            world_find_chunk(world, chunk->cx, chunk->cz)) {
+            chunk_destroy(chunk);
+            continue;
+        }
+        
+        world_try_set_spawn(world, chunk);
+        world_add_chunk(world, chunk);
+        return true;
+    }
+    return false;
+}
+
+static double stream_clock_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1000.0 + (double)ts.tv_nsec / 1e6;
+}
+
+void world_update_chunks(World *world, Vec3 player_pos, const Camera *camera) {
+    IVec3 center_cell = world_to_cell(player_pos);
+    int center_cx = cell_to_chunk(center_cell.x);
+    int center_cz = cell_to_chunk(center_cell.z);
+    
+    bool moved = !world->center_valid ||
+                 center_cx != world->center_cx ||
+                 center_cz != world->center_cz;
+    
+    /* Streaming only happens on chunk-boundary crossings or while loads are pending */
+    if (!moved && world_load_queue_empty(world) && world->in_flight_count == 0) return;
+    
+    double deadline = stream_clock_ms() + world->stream_budget_ms;
+    
+    if (moved) world_recenter(world, center_cx, center_cz);
+    if (!world_load_queue_empty(world)) world_prioritize_load_queue(world, camera);
+    
+    /* Alternate integrating and submitting until the budget runs out; at least
+     * one step always runs so streaming advances even on a slow frame */
+    for (;;) {
+        bool progressed = world_integrate_finished_load(world);
+        progressed |= world_submit_next_chunk_load(world);
+        if (!progressed || stream_clock_ms() >= deadline) break;
+    }
+}
+
 /* -------------------------------------------------------------------------- */
 /* Entity Management                                                          */
 /* -------------------------------------------------------------------------- */
@@ -702,16 +2972,16 @@ uint32_t world_write_entity_render_blocks(const World *world, void *out_data,
     return written;
 }
 
-bool world_get_block_type(World *world, IVec3 pos, uint8_t *type_out) {
+bool world_get_block_type(World *world, IVec3 pos, BlockId *type_out) {
     if (!world_y_in_bounds(pos.y)) return false;
     
-    Chunk *chunk = world_find_chunk(world, cell_to_chunk(pos.x), cell_to_chunk(pos.z));
+    Chunk *chunk = world_lookup_chunk(world, cell_to_chunk(pos.x), cell_to_chunk(pos.z));
     if (!chunk) return false;
     
     int lx, ly, lz;
     if (!chunk_world_to_local(chunk, pos, &lx, &ly, &lz)) return false;
     
-    uint8_t type = chunk_get_voxel(chunk, lx, ly, lz);
+    BlockId type = chunk_get_voxel(chunk, lx, ly, lz);
     if (is_air(type)) return false;
     
     if (type_out) *type_out = type;
@@ -722,124 +2992,308 @@ bool world_block_exists(World *world, IVec3 pos) {
     return world_get_block_type(world, pos, NULL);
 }
 
-bool world_add_block(World *world, IVec3 pos, uint8_t type) {
+bool world_add_block(World *world, IVec3 pos, BlockId type) {
+    if (!block_id_valid(type) || is_air(type)) return false;
+    
     int cx = cell_to_chunk(pos.x);
     int cz = cell_to_chunk(pos.z);
     
-    Chunk *chunk = world_find_chunk(world, cx, cz);
+    Chunk *chunk = world_lookup_chunk(world, cx, cz);
     if (!chunk) chunk = world_create_chunk(world, cx, cz);
     
     bool result = chunk_add_block(chunk, pos, type);
-    if (result) world_mark_neighbors_dirty(world, pos);
+    if (result) world_block_changed(world, pos);
     return result;
 }
 
 bool world_remove_block(World *world, IVec3 pos) {
-    Chunk *chunk = world_find_chunk(world, cell_to_chunk(pos.x), cell_to_chunk(pos.z));
+    Chunk *chunk = world_lookup_chunk(world, cell_to_chunk(pos.x), cell_to_chunk(pos.z));
     if (!chunk) return false;
     
     bool result = chunk_remove_block(chunk, pos);
-    if (result) world_mark_neighbors_dirty(world, pos);
+    if (result) world_block_changed(world, pos);
     return result;
 }
 
-int world_total_render_blocks(World *world) {
-    int total = 0;
+static void chunk_rebuild_job(void *ctx, int index) {
+    World *world = ctx;
+    chunk_rebuild_render_list(world, world->rebuild_list[index]);
+}
+
+/* Rebuilds only write their own chunk's block list and read voxels, so they can
+ * run concurrently while the main thread leaves the world untouched */
+static void world_rebuild_dirty_chunks(World *world) {
+    int dirty = 0;
     for (int i = 0; i < world->chunk_count; ++i) {
         Chunk *chunk = world->chunks[i];
-        if (chunk->render_dirty) {
-            chunk_rebuild_render_list(world, chunk);
+        if (!chunk->render_dirty || chunk->state == CHUNK_STATE_GENERATED) continue;
+        
+        if (dirty >= world->rebuild_capacity) {
+            int new_cap = world->rebuild_capacity > 0 ? world->rebuild_capacity * 2 : 64;
+            Chunk **new_list = realloc(world->rebuild_list, (size_t)new_cap * sizeof(Chunk *));
+            if (!new_list) die("Failed to allocate chunk rebuild list");
+            world->rebuild_list = new_list;
+            world->rebuild_capacity = new_cap;
         }
-        total += chunk->block_count;
+        world->rebuild_list[dirty++] = chunk;
+    }
+    
+    job_pool_parallel_for(world->jobs, dirty, chunk_rebuild_job, world);
+}
+
+void world_prepare_render(World *world, WorldRenderTotals *totals) {
+    world_rebuild_dirty_chunks(world);
+    
+    memset(totals, 0, sizeof(*totals));
+    for (int i = 0; i < world->chunk_count; ++i) {
+        Chunk *chunk = world->chunks[i];
+        for (int f = 0; f < FACE_COUNT; ++f) {
+            totals->face_counts[f] += chunk->face_counts[f];
+        }
+        for (int t = 0; t < ITEM_TYPE_COUNT; ++t) {
+            totals->mesh_index_counts[t] += chunk->mesh_index_counts[t];
+        }
+        totals->face_total += chunk->block_count;
+        totals->mesh_vertex_count += chunk->mesh_vertex_count;
+        totals->mesh_index_total += chunk->mesh_index_count;
+    }
+}
+
+void world_set_greedy_meshing(World *world, bool enabled) {
+    if (world->greedy_meshing == enabled) return;
+    
+    world->greedy_meshing = enabled;
+    for (int i = 0; i < world->chunk_count; ++i) {
+        world->chunks[i]->render_dirty = true;
     }
-    return total;
 }
 
 /* -------------------------------------------------------------------------- */
 /* Terrain Generation                                                         */
 /* -------------------------------------------------------------------------- */
 
-static void chunk_generate(World *world, Chunk *chunk) {
+/* Generation writes plain BlockIds in (y, z, x) order, section by section like
+ * ChunkSection voxels; each touched section is encoded once at the end. Only
+ * rows [0, rows) have been written or cleared, the rest reads as air. It is
+ * per-thread scratch, so rows left from the last chunk are cleared again. */
+typedef struct {
+    BlockId voxels[CHUNK_SECTION_COUNT * CHUNK_SECTION_HEIGHT][CHUNK_SIZE][CHUNK_SIZE];
+    int rows;
+} ChunkGenBuffer;
+
+static void gen_clear_rows(ChunkGenBuffer *gen, int rows) {
+    for (; gen->rows < rows; ++gen->rows) {
+        BlockId *row = &gen->voxels[gen->rows][0][0];
+        for (int i = 0; i < CHUNK_SIZE * CHUNK_SIZE; ++i) row[i] = BLOCK_AIR;
+    }
+}
+
+/* Fills world heights [y0, y1) of one column with `type`, keeping cells
+ * already placed (leaves of an earlier tree) like chunk_add_block would */
+static void gen_fill_run(ChunkGenBuffer *gen, int lx, int lz, int y0, int y1, BlockId type) {
+    int ly0 = y0 - WORLD_MIN_Y > 0 ? y0 - WORLD_MIN_Y : 0;
+    int ly1 = y1 - WORLD_MIN_Y < CHUNK_HEIGHT ? y1 - WORLD_MIN_Y : CHUNK_HEIGHT;
+    if (ly0 >= ly1) return;
+    
+    gen_clear_rows(gen, ly1);
+    for (int ly = ly0; ly < ly1; ++ly) {
+        BlockId *cell = &gen->voxels[ly][lz][lx];
+        if (is_air(*cell)) *cell = type;
+    }
+}
+
+/* A 2D noise layer sampled at (wx * scale + offset_x, wz * scale + offset_z);
+ * a single octave is plain perlin2d. Layers with step > 1 are only sampled
+ * every `step` columns and interpolated bilinearly in between. */
+typedef struct {
+    float scale;
+    float offset_x;
+    float offset_z;
+    int octaves;
+    float lacunarity;
+    float gain;
+    uint32_t seed;
+    int step;
+} NoiseLayer;
+
+/* Coarse spacing for the low-frequency layers. Coarse samples sit on world
+ * coordinates that are multiples of the step, so neighboring chunks share
+ * their border samples and the terrain stays seamless. Interpolated values
+ * stay within TERRAIN_COARSE_TOLERANCE of full-rate sampling; the error is
+ * all in the faint top octaves and shifts biome and river borders by a
+ * column in about 0.6% of columns, leaving the rest of the terrain as is. */
+#define TERRAIN_COARSE_STEP 4
+#define TERRAIN_COARSE_TOLERANCE 0.1f
+
+_Static_assert(CHUNK_SIZE % TERRAIN_COARSE_STEP == 0,
+               "TERRAIN_COARSE_STEP must divide CHUNK_SIZE");
+
+static const NoiseLayer TERRAIN_BASE = {0.045f, 0.0f, 0.0f, 4, 2.0f, 0.5f, 1234u, 1};
+static const NoiseLayer TERRAIN_MOUNTAIN = {0.02f, 0.0f, 0.0f, 5, 2.0f, 0.45f, 91011u, TERRAIN_COARSE_STEP};
+static const NoiseLayer TERRAIN_MOISTURE = {0.03f, 300.0f, -300.0f, 4, 2.0f, 0.5f, 121314u, TERRAIN_COARSE_STEP};
+static const NoiseLayer TERRAIN_HEAT = {0.03f, -600.0f, 600.0f, 4, 2.0f, 0.5f, 151617u, TERRAIN_COARSE_STEP};
+static const NoiseLayer TERRAIN_PEAKS = {0.05f, 1000.0f, -1000.0f, 4, 2.25f, 0.5f, 181920u, 1};
+static const NoiseLayer TERRAIN_DUNES = {0.08f, 2000.0f, 2000.0f, 3, 2.1f, 0.55f, 212223u, 1};
+static const NoiseLayer TERRAIN_MEADOW = {0.07f, -1500.0f, 1500.0f, 3, 2.0f, 0.5f, 242526u, 1};
+static const NoiseLayer TERRAIN_RIVER = {0.015f, 4000.0f, -4000.0f, 1, 1.0f, 1.0f, 272829u, TERRAIN_COARSE_STEP};
+
+#define GEN_COLUMNS (CHUNK_SIZE * CHUNK_SIZE)
+
+/* Evaluates `layer` in one batch at the listed columns of (fx, fz); results
+ * land in out at the same column indices. Always samples at full rate. */
+static void gen_noise_layer(const NoiseLayer *layer, const float *fx, const float *fz,
+                            const int *columns, int count, float *out) {
+    if (count <= 0) return;
+    
+    float xs[GEN_COLUMNS], zs[GEN_COLUMNS], values[GEN_COLUMNS];
+    for (int i = 0; i < count; ++i) {
+        xs[i] = fx[columns[i]] * layer->scale + layer->offset_x;
+        zs[i] = fz[columns[i]] * layer->scale + layer->offset_z;
+    }
+    
+    fbm2d_batch(xs, zs, values, count, layer->octaves, layer->lacunarity, layer->gain, layer->seed);
+    for (int i = 0; i < count; ++i) out[columns[i]] = values[i];
+}
+
+/* Evaluates `layer` for every column of the chunk at (base_x, base_z) as one
+ * grid, sharing lattice work between columns; coarse layers are sampled on
+ * the (CHUNK_SIZE / step + 1)^2 grid that includes the far chunk border */
+static void gen_noise_grid(const NoiseLayer *layer, int base_x, int base_z, float *out) {
+    const int step = layer->step;
+    const int samples = CHUNK_SIZE / step + (step > 1);
+    
+    float xs[CHUNK_SIZE + 1], zs[CHUNK_SIZE + 1];
+    for (int i = 0; i < samples; ++i) {
+        xs[i] = (float)(base_x + i * step) * layer->scale + layer->offset_x;
+        zs[i] = (float)(base_z + i * step) * layer->scale + layer->offset_z;
+    }
+    
+    if (step == 1) {
+        fbm2d_grid(xs, samples, zs, samples, out, layer->octaves, layer->lacunarity,
+                   layer->gain, layer->seed);
+        return;
+    }
+    
+    float coarse[(CHUNK_SIZE + 1) * (CHUNK_SIZE + 1)];
+    fbm2d_grid(xs, samples, zs, samples, coarse, layer->octaves, layer->lacunarity,
+               layer->gain, layer->seed);
+    
+    /* Bilinear weights along one coarse cell, shared by both axes */
+    float t[CHUNK_SIZE];
+    for (int k = 0; k < step; ++k) t[k] = (float)k / (float)step;
+    
+    for (int lx = 0, ci = 0; ci < samples - 1; ++ci) {
+        const float *row0 = &coarse[ci * samples];
+        const float *row1 = row0 + samples;
+        
+        for (int kx = 0; kx < step; ++kx, ++lx) {
+            float *column = &out[lx * CHUNK_SIZE];
+            for (int lz = 0, cj = 0; cj < samples - 1; ++cj) {
+                float a = row0[cj] + (row1[cj] - row0[cj]) * t[kx];
+                float b = row0[cj + 1] + (row1[cj + 1] - row0[cj + 1]) * t[kx];
+                for (int kz = 0; kz < step; ++kz, ++lz) column[lz] = a + (b - a) * t[kz];
+            }
+        }
+    }
+}
+
+static void chunk_generate(Chunk *chunk) {
     const int SEA_LEVEL = 3;
     const int BEDROCK_DEPTH = -4;
     
     int base_x = chunk_to_base(chunk->cx);
     int base_z = chunk_to_base(chunk->cz);
     
+    ChunkGenBuffer *gen = thread_scratch(SCRATCH_GEN, sizeof(ChunkGenBuffer));
+    gen->rows = 0;
+    
+    /* Noise for all columns first, column c = lx * CHUNK_SIZE + lz, so each
+     * layer is one grid; biome layers only run on the columns that use them */
+    float fx[GEN_COLUMNS], fz[GEN_COLUMNS];
+    for (int c = 0; c < GEN_COLUMNS; ++c) {
+        fx[c] = (float)(base_x + c / CHUNK_SIZE);
+        fz[c] = (float)(base_z + c % CHUNK_SIZE);
+    }
+    
+    float base[GEN_COLUMNS], mountain[GEN_COLUMNS], moisture[GEN_COLUMNS], heat[GEN_COLUMNS];
+    float river[GEN_COLUMNS], biome_noise[GEN_COLUMNS];
+    gen_noise_grid(&TERRAIN_BASE, base_x, base_z, base);
+    gen_noise_grid(&TERRAIN_MOUNTAIN, base_x, base_z, mountain);
+    gen_noise_grid(&TERRAIN_MOISTURE, base_x, base_z, moisture);
+    gen_noise_grid(&TERRAIN_HEAT, base_x, base_z, heat);
+    gen_noise_grid(&TERRAIN_RIVER, base_x, base_z, river);
+    
+    enum { BIOME_MOUNTAINS, BIOME_DESERT, BIOME_PLAINS, BIOME_COUNT };
+    static const NoiseLayer *const BIOME_LAYERS[BIOME_COUNT] = {
+        &TERRAIN_PEAKS, &TERRAIN_DUNES, &TERRAIN_MEADOW
+    };
+    uint8_t biome[GEN_COLUMNS];
+    int biome_columns[BIOME_COUNT][GEN_COLUMNS];
+    int biome_counts[BIOME_COUNT] = {0};
+    
+    for (int c = 0; c < GEN_COLUMNS; ++c) {
+        int wx = base_x + c / CHUNK_SIZE;
+        int wz = base_z + c % CHUNK_SIZE;
+        bool forced_plains = (abs(wx) < 5 && abs(wz) < 5);
+        float dryness = heat[c] - moisture[c];
+        
+        if (!forced_plains && mountain[c] > 0.45f) biome[c] = BIOME_MOUNTAINS;
+        else if (!forced_plains && dryness > 0.45f) biome[c] = BIOME_DESERT;
+        else biome[c] = BIOME_PLAINS;
+        biome_columns[biome[c]][biome_counts[biome[c]]++] = c;
+    }
+    for (int b = 0; b < BIOME_COUNT; ++b) {
+        if (biome_counts[b] == GEN_COLUMNS) {
+            gen_noise_grid(BIOME_LAYERS[b], base_x, base_z, biome_noise);
+        } else {
+            gen_noise_layer(BIOME_LAYERS[b], fx, fz, biome_columns[b], biome_counts[b], biome_noise);
+        }
+    }
+    
     for (int lx = 0; lx < CHUNK_SIZE; ++lx) {
         int wx = base_x + lx;
-        float fx = (float)wx;
         
         for (int lz = 0; lz < CHUNK_SIZE; ++lz) {
             int wz = base_z + lz;
-            float fz = (float)wz;
+            int c = lx * CHUNK_SIZE + lz;
             
             bool forced_plains = (abs(wx) < 5 && abs(wz) < 5);
             
             /* Terrain height and biome */
-            float base = fbm2d(fx * 0.045f, fz * 0.045f, 4, 2.0f, 0.5f, 1234u);
-            float detail = fbm2d(fx * 0.12f, fz * 0.12f, 3, 2.15f, 0.5f, 5678u);
-            float mountain = fbm2d(fx * 0.02f, fz * 0.02f, 5, 2.0f, 0.45f, 91011u);
-            float moisture = fbm2d(fx * 0.03f + 300.0f, fz * 0.03f - 300.0f, 4, 2.0f, 0.5f, 121314u);
-            float heat = fbm2d(fx * 0.03f - 600.0f, fz * 0.03f + 600.0f, 4, 2.0f, 0.5f, 151617u);
-            float dryness = heat - moisture;
-            
             BlockType surface = BLOCK_GRASS;
-            float height = 6.0f + base * 4.0f + detail * 2.5f;
+            float height;
             
-            if (!forced_plains && mountain > 0.45f) {
-                float peaks = fbm2d(fx * 0.05f + 1000.0f, fz * 0.05f - 1000.0f, 4, 2.25f, 0.5f, 181920u);
-                height = 12.0f + peaks * 12.0f;
+            if (biome[c] == BIOME_MOUNTAINS) {
+                height = 12.0f + biome_noise[c] * 12.0f;
                 surface = BLOCK_STONE;
-            } else if (!forced_plains && dryness > 0.45f) {
-                float dunes = fbm2d(fx * 0.08f + 2000.0f, fz * 0.08f + 2000.0f, 3, 2.1f, 0.55f, 212223u);
-                height = 3.0f + dunes * 3.5f;
+            } else if (biome[c] == BIOME_DESERT) {
+                height = 3.0f + biome_noise[c] * 3.5f;
                 surface = BLOCK_SAND;
             } else {
-                float meadow = fbm2d(fx * 0.07f - 1500.0f, fz * 0.07f + 1500.0f, 3, 2.0f, 0.5f, 242526u);
-                height = 6.5f + base * 3.5f + meadow * 2.0f;
+                height = 6.5f + base[c] * 3.5f + biome_noise[c] * 2.0f;
             }
             
             height = fmaxf(height, 0.5f);
             int ground_y = (int)floorf(height);
             
             /* Rivers */
-            float river = fabsf(perlin2d(fx * 0.015f + 4000.0f, fz * 0.015f - 4000.0f, 272829u));
-            bool is_river = !forced_plains && river < 0.11f;
+            bool is_river = !forced_plains && fabsf(river[c]) < 0.11f;
             
             if (is_river) {
                 ground_y = (int)fminf((float)ground_y, (float)SEA_LEVEL - 1.0f);
                 surface = BLOCK_SAND;
             }
             
-            /* Generate column */
-            IVec3 col = {wx, 0, wz};
-            
-            /* Bedrock and stone */
-            for (int y = BEDROCK_DEPTH; y < ground_y - 3; ++y) {
-                col.y = y;
-                chunk_add_block(chunk, col, BLOCK_STONE);
-            }
-            
-            /* Filler layer */
+            /* Generate column: bedrock and stone, filler layer, surface */
             BlockType filler = (surface == BLOCK_SAND || surface == BLOCK_STONE) ? surface : BLOCK_DIRT;
-            for (int y = ground_y - 3; y < ground_y; ++y) {
-                if (y >= BEDROCK_DEPTH) {
-                    col.y = y;
-                    chunk_add_block(chunk, col, filler);
-                }
-            }
-            
-            /* Surface */
-            col.y = ground_y;
-            chunk_add_block(chunk, col, surface);
+            int filler_y = ground_y - 3 > BEDROCK_DEPTH ? ground_y - 3 : BEDROCK_DEPTH;
+            gen_fill_run(gen, lx, lz, BEDROCK_DEPTH, ground_y - 3, BLOCK_STONE);
+            gen_fill_run(gen, lx, lz, filler_y, ground_y, filler);
+            gen_fill_run(gen, lx, lz, ground_y, ground_y + 1, surface);
             
             /* Water */
             if (is_river || ground_y < SEA_LEVEL) {
-                for (int y = ground_y + 1; y <= SEA_LEVEL; ++y) {
-                    col.y = y;
-                    chunk_add_block(chunk, col, BLOCK_WATER);
-                }
+                gen_fill_run(gen, lx, lz, ground_y + 1, SEA_LEVEL + 1, BLOCK_WATER);
             }
             
             /* Trees */
@@ -854,12 +3308,9 @@ static void chunk_generate(World *world, Chunk *chunk) {
                     
                     if (top_y + 2 <= WORLD_MAX_Y) {
                         /* Trunk */
-                        for (int ty = 1; ty <= trunk_height; ++ty) {
-                            col.y = ground_y + ty;
-                            chunk_add_block(chunk, col, BLOCK_WOOD);
-                        }
+                        gen_fill_run(gen, lx, lz, ground_y + 1, top_y + 1, BLOCK_WOOD);
                         
-                        /* Foliage */
+                        /* Foliage; trees stand at least two cells inside the chunk */
                         for (int y = top_y - 2; y <= top_y + 1; ++y) {
                             int dy = y - top_y;
                             for (int dx = -2; dx <= 2; ++dx) {
@@ -867,20 +3318,62 @@ static void chunk_generate(World *world, Chunk *chunk) {
                                     int dist2 = dx * dx + dz * dz + dy * dy;
                                     if (dist2 > 6 || (dx == 0 && dz == 0 && y <= top_y)) continue;
                                     
-                                    IVec3 leaf = {wx + dx, y, wz + dz};
-                                    chunk_add_block(chunk, leaf, BLOCK_LEAVES);
+                                    gen_fill_run(gen, lx + dx, lz + dz, y, y + 1, BLOCK_LEAVES);
                                 }
                             }
                         }
                     }
                 }
             }
-            
-            /* Set spawn point */
-            if (!world->spawn_set && wx == 0 && wz == 0) {
-                world->spawn_position = vec3(0.0f, (float)ground_y + 0.5f, 0.0f);
-                world->spawn_set = true;
+        }
+    }
+    
+    /* Sections above the written rows stay unallocated air */
+    int sections = (gen->rows + CHUNK_SECTION_HEIGHT - 1) / CHUNK_SECTION_HEIGHT;
+    gen_clear_rows(gen, sections * CHUNK_SECTION_HEIGHT);
+    for (int s = 0; s < sections; ++s) {
+        section_encode(&chunk->sections[s], &gen->voxels[s * CHUNK_SECTION_HEIGHT][0][0]);
+    }
+}
+
+/* Chunks hashed into the generator stamp, spread over every biome, rivers
+ * and the forced plains at the origin */
+static const ChunkCoord GENERATOR_PROBES[] = {
+    {0, 0}, {3, -2}, {-11, 7}, {24, 19}, {-37, -41}, {58, -23}, {-90, 66}, {131, 104}
+};
+
+static pthread_once_t generator_hash_once = PTHREAD_ONCE_INIT;
+static uint32_t generator_hash_value;
+
+static void generator_hash_init(void) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < sizeof(GENERATOR_PROBES) / sizeof(GENERATOR_PROBES[0]); ++i) {
+        Chunk *chunk = arena_alloc(sizeof(Chunk));
+        if (!chunk) die("Failed to allocate chunk");
+        chunk_init(chunk, GENERATOR_PROBES[i].cx, GENERATOR_PROBES[i].cz);
+        chunk_generate(chunk);
+        
+        /* FNV-1a over the encoded sections; encoding is deterministic */
+        for (int s = 0; s < CHUNK_SECTION_COUNT; ++s) {
+            const ChunkSection *section = &chunk->sections[s];
+            const uint8_t header[2] = {section->bits, section->palette_count};
+            const uint8_t *parts[3] = {header, (const uint8_t *)section->palette, section->data};
+            size_t sizes[3] = {sizeof(header), (size_t)section->palette_count * sizeof(BlockId),
+                               section_data_size(section->bits)};
+            for (int p = 0; p < 3; ++p) {
+                for (size_t b = 0; b < sizes[p]; ++b) hash = (hash ^ parts[p][b]) * 16777619u;
             }
         }
+        chunk_destroy(chunk);
     }
-}
\ No newline at end of file
+    generator_hash_value = hash;
+}
+
+/* Fingerprint of the terrain this build and CPU generate. Saves stamp it
+ * next to WORLD_GENERATOR_VERSION: noise paths and floating-point
+ * contraction differ between machines and compilers, and a probe hash
+ * catches what a version number cannot. */
+static uint32_t generator_hash(void) {
+    pthread_once(&generator_hash_once, generator_hash_init);
+    return generator_hash_value;
+}
@@ -1,17 +1,23 @@
 #ifndef WORLD_H
 #define WORLD_H
 
+#include <pthread.h>
+#include <stdatomic.h>
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
 
 #include "math.h"
 #include "entity.h"
+#include "jobs.h"
 
 /* -------------------------------------------------------------------------- */
 /* Block Types                                                                */
 /* -------------------------------------------------------------------------- */
 
+/* Blocks and items share one 16-bit ID space indexing BLOCK_REGISTRY */
+typedef uint16_t BlockId;
+
 typedef enum {
     BLOCK_DIRT = 0,
     BLOCK_STONE = 1,
@@ -22,9 +28,38 @@ typedef enum {
     BLOCK_LEAVES = 6,
     BLOCK_PLANKS = 7,
     ITEM_STICK = 8,
-    ITEM_TYPE_COUNT
+    ITEM_TYPE_COUNT,                    /* Block textures, one per type above */
+    BLOCK_AIR = ITEM_TYPE_COUNT,
+    BLOCK_ID_COUNT
 } BlockType;
 
+/* Block properties; hot paths test these with one table lookup */
+enum {
+    BLOCK_FLAG_SOLID = 1u << 0,         /* Collides with players and entities */
+    BLOCK_FLAG_OPAQUE = 1u << 1,        /* Hides faces of any block behind it */
+    BLOCK_FLAG_LIQUID = 1u << 2,        /* Hides faces of other liquids only */
+    BLOCK_FLAG_PLACEABLE = 1u << 3      /* Can be placed from the inventory */
+};
+
+typedef struct {
+    uint8_t flags;
+    uint8_t texture;    /* Renderer texture index */
+} BlockInfo;
+
+extern const BlockInfo BLOCK_REGISTRY[BLOCK_ID_COUNT];
+
+static inline bool block_has_flag(BlockId id, unsigned flag) {
+    return (BLOCK_REGISTRY[id].flags & flag) != 0;
+}
+
+static inline bool block_is_solid(BlockId id) {
+    return block_has_flag(id, BLOCK_FLAG_SOLID);
+}
+
+static inline uint8_t block_texture(BlockId id) {
+    return BLOCK_REGISTRY[id].texture;
+}
+
 enum {
     CROSSHAIR_TEXTURE_INDEX = ITEM_TYPE_COUNT,
     INVENTORY_SELECTION_TEXTURE_INDEX = ITEM_TYPE_COUNT + 1,
@@ -39,17 +74,99 @@ enum {
 
 #define CHUNK_SIZE 16
 #define WORLD_MIN_Y (-8)
-#define WORLD_MAX_Y 32
+
+/* Top build height: 256 layers by default, -DWORLD_MAX_Y=375 gives 384. Layers
+ * above the terrain are uniform air sections, so chunk memory and meshing
+ * follow the occupied sections rather than the nominal height. */
+#ifndef WORLD_MAX_Y
+#define WORLD_MAX_Y 247
+#endif
 #define CHUNK_HEIGHT (WORLD_MAX_Y - WORLD_MIN_Y + 1)
 
+/* Chunk voxels are stored in stacked sections of this height; the top section
+ * may reach past WORLD_MAX_Y, and those cells are never addressed */
+#define CHUNK_SECTION_HEIGHT 16
+#define CHUNK_SECTION_COUNT ((CHUNK_HEIGHT + CHUNK_SECTION_HEIGHT - 1) / CHUNK_SECTION_HEIGHT)
+#define CHUNK_SECTION_VOXELS (CHUNK_SIZE * CHUNK_SECTION_HEIGHT * CHUNK_SIZE)
+#define CHUNK_VOXELS (CHUNK_SIZE * CHUNK_HEIGHT * CHUNK_SIZE)
+#define CHUNK_SECTION_PALETTE_MAX 16
+
 #define ACTIVE_CHUNK_RADIUS 6
 #define CHUNK_UNLOAD_MARGIN 2
 #define MAX_LOADED_CHUNKS ((uint32_t)(((ACTIVE_CHUNK_RADIUS + CHUNK_UNLOAD_MARGIN) * 2 + 1) * \
                                        ((ACTIVE_CHUNK_RADIUS + CHUNK_UNLOAD_MARGIN) * 2 + 1)))
 
-#define WORLD_SAVE_FILE "world.vox"
+/* A chunk is meshed only once all four horizontal neighbors are loaded, so
+ * streaming fills one ring beyond the active square to keep it all drawn */
+#define CHUNK_LOAD_RADIUS (ACTIVE_CHUNK_RADIUS + 1)
+
+/* Streaming: chunks within CHUNK_SYNC_RADIUS of the player load immediately,
+ * the rest of the loaded square is generated or loaded on worker threads, with
+ * at most CHUNK_MAX_IN_FLIGHT outstanding. Pending chunks are handed out nearest
+ * first, chunks in view ahead of those behind the camera, and each update spends
+ * at most CHUNK_STREAM_BUDGET_MS on streaming work. */
+#define CHUNK_SYNC_RADIUS 1
+#define CHUNK_MAX_IN_FLIGHT 16
+#define CHUNK_STREAM_BUDGET_MS 2.0f
+
+/* Off-screen chunks are ordered as if this many times farther away */
+#define CHUNK_OFFSCREEN_DISTANCE_SCALE 2
+
+/* Chunk storage: 0 = open-addressing hash index, 1 = toroidal ring addressed by
+ * (cx mod CHUNK_RING_SIZE, cz mod CHUNK_RING_SIZE). Build with -DWORLD_CHUNK_RING=1. */
+#ifndef WORLD_CHUNK_RING
+#define WORLD_CHUNK_RING 0
+#endif
+
+/* Chunk surfaces: 0 = one instanced quad per exposed face, 1 = greedy mesher
+ * merging coplanar runs of one block type into single quads with tiled UVs.
+ * Build with -DWORLD_GREEDY_MESH=1; world_set_greedy_meshing switches at runtime. */
+#ifndef WORLD_GREEDY_MESH
+#define WORLD_GREEDY_MESH 0
+#endif
+
+/* Open-addressing chunk index; power of two, kept at most half full */
+#define CHUNK_INDEX_CAPACITY 1024u
+
+/* Ring edge length; power of two, wider than the retained chunk square */
+#define CHUNK_RING_SIZE 32u
+
+/* Saves are a directory: level.vox holds the header and player, and chunks
+ * live in region files of REGION_SIZE x REGION_SIZE chunks, each behind an
+ * offset table so single chunks are read and rewritten in place. Terrain is
+ * regenerated on load, so a chunk record holds only the player's edits. */
+#define WORLD_SAVE_DIR "world"
 #define WORLD_SAVE_MAGIC 0x58574F56u
-#define WORLD_SAVE_VERSION 1u
+#define WORLD_REGION_MAGIC 0x52584F56u
+#define WORLD_SAVE_VERSION 9u
+
+/* Terrain generator revision stamped into saves. Chunks are saved as edits
+ * over generated terrain, so bump this with any change to the noise or
+ * generation code that can move a block. */
+#define WORLD_GENERATOR_VERSION 1u
+
+/* Chunk record compression stamped into each new region file. Files keep
+ * the codec they were created with, so saves written under any setting
+ * still load. Build with -DWORLD_SAVE_CODEC=1 for RLE. */
+typedef enum {
+    SAVE_CODEC_NONE = 0,
+    SAVE_CODEC_RLE = 1,         /* Byte runs, PackBits style */
+    SAVE_CODEC_DEFLATE = 2,     /* zlib */
+    SAVE_CODEC_COUNT
+} SaveCodec;
+
+#ifndef WORLD_SAVE_CODEC
+#define WORLD_SAVE_CODEC SAVE_CODEC_DEFLATE
+#endif
+
+#define REGION_SIZE 32
+#define REGION_CHUNKS (REGION_SIZE * REGION_SIZE)
+
+/* Records are stored in whole sectors; the table occupies the first ones */
+#define REGION_SECTOR_SIZE 128u
+
+/* Region files kept open at once; the least recently used one is closed */
+#define REGION_CACHE_SIZE 16
 
 #define INITIAL_INSTANCE_CAPACITY 200000u
 #define MAX_INSTANCE_CAPACITY 1500000u
@@ -63,52 +180,197 @@ typedef struct {
     Vec3 max;
 } AABB;
 
+/* Cube face directions, in the order of the face groups in the renderer's
+ * cube mesh (four vertices and six indices per face) */
+typedef enum {
+    FACE_POS_Z = 0,
+    FACE_NEG_Z = 1,
+    FACE_POS_Y = 2,
+    FACE_NEG_Y = 3,
+    FACE_POS_X = 4,
+    FACE_NEG_X = 5,
+    FACE_COUNT
+} FaceDirection;
+
+/* One exposed face of a voxel */
 typedef struct {
     IVec3 pos;
-    uint8_t type;
+    BlockId type;
+    uint8_t face;
 } Block;
 
+/* Horizontal chunk neighbors; opposite directions differ in the lowest bit */
+typedef enum {
+    CHUNK_NEIGHBOR_WEST = 0,    /* -x */
+    CHUNK_NEIGHBOR_EAST = 1,    /* +x */
+    CHUNK_NEIGHBOR_NORTH = 2,   /* -z */
+    CHUNK_NEIGHBOR_SOUTH = 3,   /* +z */
+    CHUNK_NEIGHBOR_COUNT
+} ChunkNeighbor;
+
+/* Greedy mesh vertex in world space; same layout as the renderer's Vertex */
+typedef struct {
+    Vec3 pos;
+    Vec2 uv;
+} MeshVertex;
+
 typedef struct {
     int32_t cx;
     int32_t cz;
-    uint8_t *voxels;
+} ChunkCoord;
+
+typedef struct {
+    ChunkCoord coord;
+    uint32_t priority;  /* Lower loads first */
+} ChunkLoadRequest;
+
+/* One CHUNK_SECTION_HEIGHT slab of a chunk, palette compressed: `data` packs
+ * one palette index per voxel in (y, z, x) order at 1, 2 or 4 bits, or holds
+ * raw BlockIds at 16 bits. A section of a single type (all air, all stone)
+ * has 0 bits, no data, and reads as palette[0]. */
+typedef struct {
+    uint8_t *data;
+    uint8_t bits;
+    uint8_t palette_count;
+    BlockId palette[CHUNK_SECTION_PALETTE_MAX];
+} ChunkSection;
+
+/* One player edit: a voxel index in (y, z, x) chunk order and the block now
+ * there. `generated` is what the terrain held, so an edit undone by hand is
+ * dropped; it lives in memory only and is recomputed when edits load. */
+typedef struct {
+    uint32_t voxel;
+    BlockId block;
+    BlockId generated;
+} ChunkEdit;
+
+/* A chunk's edits as stored; no edits removes the chunk from its region */
+typedef struct {
+    int32_t cx;
+    int32_t cz;
+    ChunkEdit *edits;
+    int edit_count;
 } ChunkRecord;
 
 typedef struct Player Player;
+typedef struct Camera Camera;
+
+typedef struct SaveRegion SaveRegion;
 
 typedef struct {
+    /* Chunks stored since the last flush, not yet written to their regions */
     ChunkRecord *records;
     int count;
     int capacity;
-    bool dirty;
     char path[256];
+    
+    /* Player changed since the last flush */
+    bool player_dirty;
+    
+    /* Guards records, the writer batch and the writer state */
+    pthread_mutex_t lock;
+    
+    /* Region cache, shared by loads and the writer */
+    SaveRegion *regions[REGION_CACHE_SIZE];
+    uint64_t region_clock;
+    pthread_mutex_t region_lock;
+    
+    /* Writer thread. A flush hands over the stored records as one immutable
+     * batch plus an encoded copy of the player block; the game keeps storing
+     * into a fresh list while the batch is written. */
+    pthread_t writer;
+    pthread_cond_t writer_wake;
+    pthread_cond_t writer_idle;
+    bool writer_busy;
+    bool writer_stop;
+    ChunkRecord *writing;
+    int writing_count;
+    int writing_capacity;
+    uint8_t *writing_player;
+    size_t writing_player_size;
 
     /* Player save data */
     bool has_player_data;
     Vec3 player_position;
     uint8_t player_health;
     uint8_t player_selected_slot;
-    uint8_t player_inventory[27];
+    BlockId player_inventory[27];
     uint8_t player_inventory_counts[27];
 } WorldSave;
 
+/* Chunk lifecycle. Border faces depend on neighbor voxels, so meshing waits
+ * for all four neighbors instead of guessing air and rebuilding later. */
+typedef enum {
+    CHUNK_STATE_GENERATED = 0,      /* Voxels only; a neighbor is missing */
+    CHUNK_STATE_NEIGHBORS_READY,    /* All neighbors loaded, first mesh pending */
+    CHUNK_STATE_MESHED              /* Faces or mesh built against all neighbors */
+} ChunkState;
+
 typedef struct Chunk {
     int cx, cz;
-    uint8_t *voxels;
+    int list_index;
+    ChunkSection sections[CHUNK_SECTION_COUNT];
     
+    /* Loaded horizontal neighbors, NULL where none is loaded */
+    struct Chunk *neighbors[CHUNK_NEIGHBOR_COUNT];
+    ChunkState state;
+    
+    /* Exposed faces, grouped by direction in FaceDirection order */
     Block *blocks;
     int block_count;
     int block_capacity;
+    int face_counts[FACE_COUNT];
+    uint32_t *face_slots[CHUNK_SECTION_COUNT];  /* Per section (voxel, face) -> blocks
+                                                 * index, built on first edit there */
+    
+    /* Greedy mesh; indices are chunk-local and grouped by block texture */
+    MeshVertex *mesh_vertices;
+    int mesh_vertex_count;
+    int mesh_vertex_capacity;
+    uint32_t *mesh_indices;
+    int mesh_index_count;
+    int mesh_index_capacity;
+    int mesh_index_counts[ITEM_TYPE_COUNT];
+    
+    /* Player edits over the generated terrain, sorted by voxel; only these
+     * are saved, and `dirty` means they changed since the last store */
+    ChunkEdit *edits;
+    int edit_count;
+    int edit_capacity;
     
     bool dirty;
     bool render_dirty;
 } Chunk;
 
+typedef struct ChunkLoadJob ChunkLoadJob;
+
 typedef struct World {
     Chunk **chunks;
     int chunk_count;
     int chunk_capacity;
     
+    Chunk **chunk_index;
+    Chunk *lookup_hint;     /* Last chunk hit by a block query */
+    int center_cx, center_cz;
+    bool center_valid;
+    
+    /* Binary min-heap on priority */
+    ChunkLoadRequest *load_queue;
+    int load_queue_count;
+    int load_queue_capacity;
+    float stream_budget_ms;
+    
+    JobPool *jobs;
+    ChunkCoord in_flight[CHUNK_MAX_IN_FLIGHT];
+    int in_flight_count;
+    _Atomic(ChunkLoadJob *) finished_loads;
+    ChunkLoadJob *ready_loads;
+    
+    /* Scratch list of render-dirty chunks rebuilt in parallel */
+    Chunk **rebuild_list;
+    int rebuild_capacity;
+    bool greedy_meshing;
+    
     Vec3 spawn_position;
     bool spawn_set;
     
@@ -119,6 +381,15 @@ typedef struct World {
     int entity_capacity;
 } World;
 
+/* Per-frame geometry totals across all loaded chunks */
+typedef struct {
+    int face_counts[FACE_COUNT];
+    int face_total;
+    int mesh_vertex_count;
+    int mesh_index_counts[ITEM_TYPE_COUNT];
+    int mesh_index_total;
+} WorldRenderTotals;
+
 /* -------------------------------------------------------------------------- */
 /* Utility Functions                                                          */
 /* -------------------------------------------------------------------------- */
@@ -126,7 +397,7 @@ typedef struct World {
 IVec3 world_to_cell(Vec3 p);
 AABB cell_aabb(IVec3 cell);
 bool world_y_in_bounds(int y);
-bool item_is_placeable(uint8_t type);
+bool item_is_placeable(BlockId type);
 
 /* -------------------------------------------------------------------------- */
 /* World Save API                                                             */
@@ -134,7 +405,11 @@ bool item_is_placeable(uint8_t type);
 
 void world_save_init(WorldSave *save, const char *path);
 bool world_save_load(WorldSave *save);
+/* Starts writing everything stored so far in the background */
 void world_save_flush(WorldSave *save);
+
+/* Flushes and waits until it is all on disk */
+void world_save_sync(WorldSave *save);
 void world_save_destroy(WorldSave *save);
 
 /* -------------------------------------------------------------------------- */
@@ -150,14 +425,20 @@ bool world_save_load_player(const WorldSave *save, Player *player);
 
 void world_init(World *world, WorldSave *save);
 void world_destroy(World *world);
-void world_update_chunks(World *world, Vec3 player_pos);
+void world_update_chunks(World *world, Vec3 player_pos, const Camera *camera);
+
+/* Stores loaded chunks edited since they were last saved; the next
+ * world_save_flush writes them */
+void world_save_edited_chunks(World *world);
 
-bool world_get_block_type(World *world, IVec3 pos, uint8_t *type_out);
+bool world_get_block_type(World *world, IVec3 pos, BlockId *type_out);
 bool world_block_exists(World *world, IVec3 pos);
-bool world_add_block(World *world, IVec3 pos, uint8_t type);
+bool world_add_block(World *world, IVec3 pos, BlockId type);
 bool world_remove_block(World *world, IVec3 pos);
 
-int world_total_render_blocks(World *world);
+/* Rebuilds dirty chunks and sums their face and mesh sizes */
+void world_prepare_render(World *world, WorldRenderTotals *totals);
+void world_set_greedy_meshing(World *world, bool enabled);
 
 /* -------------------------------------------------------------------------- */
 /* Entity Management                                                          */